@@ -0,0 +1,431 @@
+#ifndef ASSIGNMENTS_DG_CONTRACTION_HIERARCHY_H_
+#define ASSIGNMENTS_DG_CONTRACTION_HIERARCHY_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/indexed_heap.h"
+
+namespace gdwg {
+
+// contraction hierarchy of a directed graph in compressed sparse row form, with non-negative
+// arithmetic weights
+// nodes are contracted one by one, cheapest first, and a shortcut arc is added between the
+// neighbours of a node whenever it lies on their only shortest path
+// a query is then a bidirectional Dijkstra that only climbs to higher contracted nodes, which
+// settles a small fraction of the graph, and shortcuts are unpacked into the original path
+// contraction stops once the remaining core gets dense, as on random graphs, and queries search
+// the core in every direction
+template <typename W>
+class ContractionHierarchy {
+  static_assert(std::is_arithmetic<W>::value, "ContractionHierarchy needs arithmetic weights");
+
+ public:
+  using id_type = std::uint32_t;
+
+  // the out-arcs of node i are at [offsets[i], offsets[i + 1]) of dsts and weights
+  ContractionHierarchy(const std::vector<std::size_t>& offsets, const std::vector<id_type>& dsts,
+                       const std::vector<W>& weights);
+
+  std::size_t NodeCount() const noexcept { return rank_.size(); }
+
+  std::size_t ShortcutCount() const noexcept { return shortcuts_; }
+
+  // number of nodes left uncontracted
+  std::size_t CoreSize() const noexcept { return rank_.size() - core_rank_; }
+
+  // ids on a shortest path from src to dst, both included, empty if dst is unreachable
+  std::vector<id_type> Path(id_type src, id_type dst) const;
+
+ private:
+  static constexpr id_type no_id = std::numeric_limits<id_type>::max();
+
+  // arc to a neighbour, middle is the contracted node a shortcut skips, or no_id
+  struct arc {
+    id_type to;
+    W weight;
+    id_type middle;
+  };
+
+  // arcs grouped by node in compressed sparse row form
+  struct arc_table {
+    std::vector<std::size_t> offsets;
+    std::vector<arc> arcs;
+  };
+
+  // per thread state of a query, reset through the touched ids only
+  struct search {
+    std::vector<W> distances;
+    std::vector<id_type> parents;
+    std::vector<id_type> touched;
+    IndexedHeap<W> heap;
+  };
+
+  // helper function, contract every node and fill rank_, up_ and down_
+  void Contract(std::vector<std::vector<arc>> out, std::vector<std::vector<arc>> in);
+
+  // helper function, the arc between two nodes of the hierarchy
+  const arc& FindArc(id_type from, id_type to) const;
+
+  // helper function, append the original nodes on the arc from -> to, from itself excluded
+  void Unpack(id_type from, id_type to, std::vector<id_type>& path) const;
+
+  // helper function, if the arc from -> to is in up_, rather than only in down_
+  bool IsUpward(id_type from, id_type to) const noexcept {
+    return rank_[from] < rank_[to] || (rank_[from] >= core_rank_ && rank_[to] >= core_rank_);
+  }
+
+  // rank_[i] is the position of node i in the contraction order, nodes ranked from core_rank_
+  // up were left uncontracted
+  // up_ has the arcs to higher ranked nodes by src, down_ the arcs from higher ranked nodes by
+  // dst, with arc::to holding the src, so both searches of a query climb the ranks
+  // arcs between core nodes are in both tables
+  std::vector<id_type> rank_;
+  id_type core_rank_ = 0;
+  arc_table up_;
+  arc_table down_;
+  std::size_t shortcuts_ = 0;
+};
+
+namespace contraction_detail {
+
+// witness searches give up after this many settled nodes, and the shortcut is kept
+// a missed witness only costs a redundant shortcut, never a wrong distance
+constexpr std::size_t witness_settle_limit = 100;
+
+// contraction stops once the remaining nodes have this many arcs each on average
+constexpr std::size_t core_degree = 16;
+
+}  // namespace contraction_detail
+
+template <typename W>
+ContractionHierarchy<W>::ContractionHierarchy(const std::vector<std::size_t>& offsets,
+                                              const std::vector<id_type>& dsts,
+                                              const std::vector<W>& weights) {
+  std::size_t count = offsets.empty() ? 0 : offsets.size() - 1;
+  std::vector<std::vector<arc>> out(count);
+  std::vector<std::vector<arc>> in(count);
+  for (id_type from = 0; from < count; ++from) {
+    for (std::size_t edge = offsets[from]; edge < offsets[from + 1]; ++edge) {
+      if (weights[edge] < W{}) {
+        throw std::runtime_error("Cannot build ContractionHierarchy on negative weights");
+      }
+      // self loops are never on a shortest path
+      id_type to = dsts[edge];
+      if (to == from) {
+        continue;
+      }
+      // arcs are sorted by dst then weight, so only the first of parallel arcs is kept
+      if (!out[from].empty() && out[from].back().to == to) {
+        continue;
+      }
+      out[from].push_back({to, weights[edge], no_id});
+      in[to].push_back({from, weights[edge], no_id});
+    }
+  }
+  Contract(std::move(out), std::move(in));
+}
+
+template <typename W>
+void ContractionHierarchy<W>::Contract(std::vector<std::vector<arc>> out,
+                                       std::vector<std::vector<arc>> in) {
+  std::size_t count = out.size();
+  rank_.assign(count, no_id);
+
+  // scratch of the witness searches
+  std::vector<W> distances(count);
+  std::vector<bool> reached(count, false);
+  std::vector<id_type> touched;
+  IndexedHeap<W> heap{count};
+
+  // shortcuts {from, to, weight} needed to contract v, found by a bounded Dijkstra from every
+  // in-neighbour over the remaining nodes without v
+  std::vector<std::tuple<id_type, id_type, W>> shortcuts;
+  auto find_shortcuts = [&](id_type v) {
+    shortcuts.clear();
+    for (const auto& from : in[v]) {
+      if (rank_[from.to] != no_id) {
+        continue;
+      }
+      W limit{};
+      for (const auto& to : out[v]) {
+        if (rank_[to.to] == no_id && to.to != from.to) {
+          limit = std::max(limit, from.weight + to.weight);
+        }
+      }
+
+      distances[from.to] = W{};
+      reached[from.to] = true;
+      touched.push_back(from.to);
+      heap.Push(from.to, W{});
+      for (std::size_t settled = 0;
+           !heap.Empty() && settled < contraction_detail::witness_settle_limit; ++settled) {
+        id_type node = heap.TopId();
+        W distance = heap.TopKey();
+        heap.Pop();
+        if (limit < distance) {
+          break;
+        }
+        for (const auto& next : out[node]) {
+          if (next.to == v || rank_[next.to] != no_id) {
+            continue;
+          }
+          W candidate = distance + next.weight;
+          if (!reached[next.to] || candidate < distances[next.to]) {
+            if (!reached[next.to]) {
+              reached[next.to] = true;
+              touched.push_back(next.to);
+            }
+            distances[next.to] = candidate;
+            heap.Push(next.to, candidate);
+          }
+        }
+      }
+
+      for (const auto& to : out[v]) {
+        if (rank_[to.to] != no_id || to.to == from.to) {
+          continue;
+        }
+        W through = from.weight + to.weight;
+        if (!reached[to.to] || through < distances[to.to]) {
+          shortcuts.emplace_back(from.to, to.to, through);
+        }
+      }
+
+      heap.Clear();
+      for (id_type node : touched) {
+        reached[node] = false;
+      }
+      touched.clear();
+    }
+  };
+
+  // edge difference plus contracted neighbours, the usual cheap ordering heuristic
+  // removed is the number of arcs between remaining nodes that contracting v takes away
+  std::vector<std::int64_t> contracted_neighbours(count, 0);
+  std::size_t removed = 0;
+  auto priority = [&](id_type v) {
+    find_shortcuts(v);
+    removed = 0;
+    for (const auto& a : in[v]) {
+      removed += rank_[a.to] == no_id;
+    }
+    for (const auto& a : out[v]) {
+      removed += rank_[a.to] == no_id;
+    }
+    return static_cast<std::int64_t>(shortcuts.size()) - static_cast<std::int64_t>(removed) +
+           contracted_neighbours[v];
+  };
+
+  // add or shorten the arc from -> to in both adjacency lists, return if it is a new arc
+  auto add_arc = [&](id_type from, id_type to, W weight, id_type middle) {
+    auto same_to = [to](const arc& a) { return a.to == to; };
+    auto existing = std::find_if(out[from].begin(), out[from].end(), same_to);
+    if (existing == out[from].end()) {
+      out[from].push_back({to, weight, middle});
+      in[to].push_back({from, weight, middle});
+      ++shortcuts_;
+      return true;
+    }
+    if (weight < existing->weight) {
+      *existing = {to, weight, middle};
+      auto same_from = [from](const arc& a) { return a.to == from; };
+      *std::find_if(in[to].begin(), in[to].end(), same_from) = {from, weight, middle};
+    }
+    return false;
+  };
+
+  // priorities go stale as neighbours are contracted, so they are refreshed lazily on pop
+  IndexedHeap<std::int64_t> order{count};
+  std::size_t live_arcs = 0;
+  for (id_type v = 0; v < count; ++v) {
+    order.Push(v, priority(v));
+    live_arcs += out[v].size();
+  }
+  id_type next_rank = 0;
+  while (!order.Empty() && live_arcs <= contraction_detail::core_degree * order.Size()) {
+    id_type v = order.TopId();
+    order.Pop();
+    std::int64_t current = priority(v);
+    if (!order.Empty() && order.TopKey() < current) {
+      order.Push(v, current);
+      continue;
+    }
+
+    // shortcuts is filled for v by the priority just computed
+    live_arcs -= removed;
+    for (const auto& [from, to, weight] : shortcuts) {
+      live_arcs += add_arc(from, to, weight, v);
+    }
+    rank_[v] = next_rank++;
+    for (const auto& a : in[v]) {
+      ++contracted_neighbours[a.to];
+    }
+    for (const auto& a : out[v]) {
+      ++contracted_neighbours[a.to];
+    }
+  }
+
+  // the dense rest is the core, in any order
+  core_rank_ = next_rank;
+  for (; !order.Empty(); order.Pop()) {
+    rank_[order.TopId()] = next_rank++;
+  }
+
+  // split every arc into the upward and downward tables
+  up_.offsets.assign(count + 1, 0);
+  down_.offsets.assign(count + 1, 0);
+  for (id_type from = 0; from < count; ++from) {
+    for (const auto& a : out[from]) {
+      up_.offsets[from + 1] += IsUpward(from, a.to);
+      down_.offsets[a.to + 1] += IsUpward(a.to, from);
+    }
+  }
+  std::partial_sum(up_.offsets.begin(), up_.offsets.end(), up_.offsets.begin());
+  std::partial_sum(down_.offsets.begin(), down_.offsets.end(), down_.offsets.begin());
+  up_.arcs.resize(up_.offsets.back());
+  down_.arcs.resize(down_.offsets.back());
+  std::vector<std::size_t> up_next(up_.offsets.begin(), up_.offsets.end() - 1);
+  std::vector<std::size_t> down_next(down_.offsets.begin(), down_.offsets.end() - 1);
+  for (id_type from = 0; from < count; ++from) {
+    for (const auto& a : out[from]) {
+      if (IsUpward(from, a.to)) {
+        up_.arcs[up_next[from]++] = a;
+      }
+      if (IsUpward(a.to, from)) {
+        down_.arcs[down_next[a.to]++] = {from, a.weight, a.middle};
+      }
+    }
+  }
+}
+
+template <typename W>
+std::vector<typename ContractionHierarchy<W>::id_type>
+ContractionHierarchy<W>::Path(id_type src, id_type dst) const {
+  // one scratch per thread, so queries on a shared hierarchy do not allocate or contend
+  thread_local search forward;
+  thread_local search backward;
+  for (search* side : {&forward, &backward}) {
+    if (side->distances.size() < NodeCount()) {
+      side->distances.resize(NodeCount());
+      side->parents.resize(NodeCount(), no_id);
+      side->heap.Reserve(NodeCount());
+    }
+  }
+  auto start = [](search& side, id_type id) {
+    side.distances[id] = W{};
+    side.parents[id] = id;
+    side.touched.push_back(id);
+    side.heap.Push(id, W{});
+  };
+  start(forward, src);
+  start(backward, dst);
+
+  // best is the length of the shortest src -> meet -> dst path seen so far
+  // a side stops once its smallest key can no longer improve on best
+  W best{};
+  id_type meet = no_id;
+  auto improves = [&](const search& side) {
+    return !side.heap.Empty() && (meet == no_id || side.heap.TopKey() < best);
+  };
+  while (improves(forward) || improves(backward)) {
+    bool forward_turn =
+        improves(forward) && (!improves(backward) ||
+                              !(backward.heap.TopKey() < forward.heap.TopKey()));
+    search& side = forward_turn ? forward : backward;
+    const search& other = forward_turn ? backward : forward;
+    const arc_table& table = forward_turn ? up_ : down_;
+
+    id_type node = side.heap.TopId();
+    W distance = side.heap.TopKey();
+    side.heap.Pop();
+    if (other.parents[node] != no_id) {
+      W through = distance + other.distances[node];
+      if (meet == no_id || through < best) {
+        best = through;
+        meet = node;
+      }
+    }
+    for (std::size_t i = table.offsets[node]; i < table.offsets[node + 1]; ++i) {
+      const arc& a = table.arcs[i];
+      W candidate = distance + a.weight;
+      if (side.parents[a.to] == no_id || candidate < side.distances[a.to]) {
+        if (side.parents[a.to] == no_id) {
+          side.touched.push_back(a.to);
+        }
+        side.distances[a.to] = candidate;
+        side.parents[a.to] = node;
+        side.heap.Push(a.to, candidate);
+      }
+    }
+  }
+
+  std::vector<id_type> path;
+  if (meet != no_id) {
+    // climb from meet back to src, then unpack the arcs in order
+    std::vector<id_type> up_chain;
+    for (id_type id = meet; id != src; id = forward.parents[id]) {
+      up_chain.push_back(id);
+    }
+    path.push_back(src);
+    for (auto it = up_chain.rbegin(); it != up_chain.rend(); ++it) {
+      Unpack(forward.parents[*it], *it, path);
+    }
+    // climb from meet to dst, these arcs already point forward
+    for (id_type id = meet; id != dst; id = backward.parents[id]) {
+      Unpack(id, backward.parents[id], path);
+    }
+  }
+
+  for (search* side : {&forward, &backward}) {
+    for (id_type id : side->touched) {
+      side->parents[id] = no_id;
+    }
+    side->touched.clear();
+    side->heap.Clear();
+  }
+  return path;
+}
+
+template <typename W>
+const typename ContractionHierarchy<W>::arc& ContractionHierarchy<W>::FindArc(id_type from,
+                                                                              id_type to) const {
+  // every pair of nodes has at most one arc, stored at its lower ranked end, or in up_ for the core
+  if (IsUpward(from, to)) {
+    auto first = up_.arcs.begin() + up_.offsets[from];
+    auto last = up_.arcs.begin() + up_.offsets[from + 1];
+    return *std::find_if(first, last, [to](const arc& a) { return a.to == to; });
+  }
+  auto first = down_.arcs.begin() + down_.offsets[to];
+  auto last = down_.arcs.begin() + down_.offsets[to + 1];
+  return *std::find_if(first, last, [from](const arc& a) { return a.to == from; });
+}
+
+template <typename W>
+void ContractionHierarchy<W>::Unpack(id_type from, id_type to, std::vector<id_type>& path) const {
+  // explicit stack of arcs, a shortcut is replaced by its two halves with the first on top
+  std::vector<std::pair<id_type, id_type>> stack{{from, to}};
+  while (!stack.empty()) {
+    auto [first, last] = stack.back();
+    stack.pop_back();
+    id_type middle = FindArc(first, last).middle;
+    if (middle == no_id) {
+      path.push_back(last);
+    } else {
+      stack.emplace_back(middle, last);
+      stack.emplace_back(first, middle);
+    }
+  }
+}
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_CONTRACTION_HIERARCHY_H_
@@ -1,22 +1,48 @@
 #ifndef ASSIGNMENTS_DG_GRAPH_H_
 #define ASSIGNMENTS_DG_GRAPH_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <numeric>
 #include <set>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "assignments/dg/contraction_hierarchy.h"
+#include "assignments/dg/reachability_index.h"
+
 namespace gdwg {
 
 template <typename N, typename E>
 class Graph {
  public:
+  // dense id of a node within a graph, ids of deleted nodes are reused by new nodes
+  using node_id = std::uint32_t;
+
+  // id standing for no node, e.g. the parent of an unreached node in a search
+  static constexpr node_id no_node = std::numeric_limits<node_id>::max();
+
+  // node is interned once with its id, connections refer to it instead of storing its value
+  struct node {
+    N value;
+    node_id id;
+  };
+
   // node pointer is shared for not storing duplications of node in connections
-  using node_ptr = std::shared_ptr<N>;
+  // a node never changes after insertion, so copies of a graph share the same nodes
+  using node_ptr = std::shared_ptr<const node>;
 
   // connection is records of edges, storing {src, dst, weight} as a tuple
-  using connection = std::tuple<node_ptr, node_ptr, E>;
+  // src and dst are owned by nodes_, the raw pointers avoid reference counting on every copy
+  using connection = std::tuple<const node*, const node*, E>;
 
   // iterator
   class const_iterator {
@@ -60,13 +86,497 @@ class Graph {
   // reverse the iterator
   using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
-  Graph() = default;
+  // fields of the stored nodes and connections, projected by the views below
+  struct node_field {
+    const N& operator()(const node_ptr& node) const { return node->value; }
+  };
+
+  struct dst_field {
+    const N& operator()(const connection& conn) const { return std::get<1>(conn)->value; }
+  };
+
+  struct weight_field {
+    const E& operator()(const connection& conn) const { return std::get<2>(conn); }
+  };
+
+  // forward iterator yielding one field of the underlying nodes or connections by const reference
+  // with Distinct, runs of the same node are yielded once, they are adjacent as the set is sorted
+  template <typename Base, typename Value, typename Field, bool Distinct = false>
+  class field_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Value;
+    using reference = const Value&;
+    using pointer = const Value*;
+    using difference_type = std::ptrdiff_t;
+
+    // constructor, takes in the underlying iterator and the end of its range
+    field_iterator(Base it, Base end) : it_{it}, end_{end} {}
+
+    reference operator*() const { return Field{}(*it_); }
+
+    pointer operator->() const { return &Field{}(*it_); }
+
+    field_iterator& operator++() {
+      // nodes are interned, so the same node always has the same address
+      pointer current = &Field{}(*it_);
+      ++it_;
+      if constexpr (Distinct) {
+        while (it_ != end_ && &Field{}(*it_) == current) {
+          ++it_;
+        }
+      }
+      return *this;
+    }
+
+    field_iterator operator++(int) {
+      // post-increment, make a copy and increment the copy
+      field_iterator it{*this};
+      ++(*this);
+      return it;
+    }
+
+    friend bool operator==(const field_iterator& lhs, const field_iterator& rhs) {
+      return lhs.it_ == rhs.it_;
+    }
+
+    friend bool operator!=(const field_iterator& lhs, const field_iterator& rhs) {
+      return lhs.it_ != rhs.it_;
+    }
+
+   private:
+    Base it_;
+    Base end_;
+  };
+
+  // lazy, non-owning range over the graph storage, invalidated when the graph changes
+  template <typename Iterator>
+  class view {
+   public:
+    using iterator = Iterator;
+
+    view(Iterator begin, Iterator end) : begin_{begin}, end_{end} {}
+
+    Iterator begin() const { return begin_; }
+
+    Iterator end() const { return end_; }
+
+    bool empty() const { return begin_ == end_; }
+
+   private:
+    Iterator begin_;
+    Iterator end_;
+  };
+
+  using nodes_view =
+      view<field_iterator<typename std::set<node_ptr>::const_iterator, N, node_field>>;
+
+  // lazy traversal made by Bfs() and Dfs(), defined at the end of the class
+  class traversal;
+
+  using connected_view =
+      view<field_iterator<typename std::set<connection>::const_iterator, N, dst_field, true>>;
+
+  using weights_view =
+      view<field_iterator<typename std::set<connection>::const_iterator, E, weight_field>>;
+
+  // immutable compressed sparse row snapshot of a graph, made by Freeze()
+  // nodes are renumbered 0 to NodeCount() - 1 in sorted order, out-edges of node i are stored at
+  // [Offsets()[i], Offsets()[i + 1]) of Dsts() and Weights(), sorted by dst then weight
+  // in-edges are stored the same way, at [InOffsets()[i], InOffsets()[i + 1]) of Srcs() and
+  // InWeights(), sorted by src then weight
+  class snapshot {
+    // friend for outer class filling the arrays
+    friend class Graph;
+
+   public:
+    // iterator over edges, in the same order and shape as Graph::const_iterator
+    class const_iterator {
+      // friends for snapshot and results constructing the iterator
+      friend class snapshot;
+      friend class Graph;
+
+     public:
+      using iterator_category = std::bidirectional_iterator_tag;
+      using value_type = std::tuple<N, N, E>;
+      using reference = std::tuple<const N&, const N&, const E&>;
+      using pointer = std::tuple<const N&, const N&, const E&>;
+      using difference_type = int;
+
+      const_iterator& operator++();
+
+      const const_iterator operator++(int);
+
+      const_iterator& operator--();
+
+      const const_iterator operator--(int);
+
+      const reference operator*() const;
+
+      friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) {
+        return lhs.edge_ == rhs.edge_;
+      }
+
+      friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) {
+        return lhs.edge_ != rhs.edge_;
+      }
+
+     private:
+      // constructor, takes in the snapshot and an edge index
+      const_iterator(const snapshot* frozen, std::size_t edge);
+
+      // constructor, for callers already knowing the src of the edge
+      const_iterator(const snapshot* frozen, node_id src, std::size_t edge)
+        : frozen_{frozen}, src_{src}, edge_{edge} {}
+
+      // storing the src of the current edge, so it is not searched on every dereference
+      const snapshot* frozen_;
+      node_id src_;
+      std::size_t edge_;
+    };
+
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    std::size_t NodeCount() const noexcept { return nodes_.size(); }
+
+    std::size_t EdgeCount() const noexcept { return dsts_.size(); }
+
+    const N& Node(node_id id) const { return nodes_[id]->value; }
+
+    node_id Id(const N& val) const;
+
+    bool IsNode(const N& val) const;
+
+    const std::vector<std::size_t>& Offsets() const noexcept { return offsets_; }
+
+    const std::vector<node_id>& Dsts() const noexcept { return dsts_; }
+
+    const std::vector<E>& Weights() const noexcept { return weights_; }
+
+    const std::vector<std::size_t>& InOffsets() const noexcept { return in_offsets_; }
+
+    const std::vector<node_id>& Srcs() const noexcept { return srcs_; }
+
+    const std::vector<E>& InWeights() const noexcept { return in_weights_; }
+
+    std::size_t OutDegree(node_id id) const { return offsets_[id + 1] - offsets_[id]; }
+
+    std::size_t InDegree(node_id id) const { return in_offsets_[id + 1] - in_offsets_[id]; }
+
+    // degree of every node, parallel edges counted, and the number of nodes of every degree
+    // from 0 to the largest, each in O(V)
+    std::vector<std::size_t> OutDegrees() const;
+
+    std::vector<std::size_t> InDegrees() const;
+
+    std::vector<std::size_t> OutDegreeHistogram() const;
 
-  Graph<N, E>(typename std::vector<N>::const_iterator begin,
-              typename std::vector<N>::const_iterator end);
+    std::vector<std::size_t> InDegreeHistogram() const;
 
-  Graph<N, E>(typename std::vector<std::tuple<N, N, E>>::const_iterator,
-              typename std::vector<std::tuple<N, N, E>>::const_iterator);
+    // sparse matrix-vector product y = A^T x, where A[src][dst] is the weight of an edge, so
+    // y[dst] is the sum of w * x[src] over the in-edges of dst, parallel edges are summed
+    // the nodes are split across up to threads threads of the shared pool, all if 0
+    template <typename T>
+    std::vector<T> Multiply(const std::vector<T>& x, std::size_t threads = 0) const;
+
+    const_iterator cbegin() const noexcept { return const_iterator{this, 0}; }
+
+    const_iterator cend() const noexcept { return const_iterator{this, dsts_.size()}; }
+
+    const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator{cend()}; }
+
+    const_reverse_iterator crend() const noexcept { return const_reverse_iterator{cbegin()}; }
+
+    const_iterator begin() const noexcept { return cbegin(); }
+
+    const_iterator end() const noexcept { return cend(); }
+
+    const_reverse_iterator rbegin() const noexcept { return crbegin(); }
+
+    const_reverse_iterator rend() const noexcept { return crend(); }
+
+   private:
+    // nodes are shared with the graph, and stay alive after the graph changes
+    std::vector<node_ptr> nodes_;
+    std::vector<std::size_t> offsets_;
+    std::vector<node_id> dsts_;
+    std::vector<E> weights_;
+    std::vector<std::size_t> in_offsets_;
+    std::vector<node_id> srcs_;
+    std::vector<E> in_weights_;
+  };
+
+  // result of ShortestPaths(), the distances and a shortest path tree from one src
+  // it keeps the snapshot it was computed on, so its node references outlive changes to the graph
+  class shortest_paths {
+    // friend for outer class filling the tree
+    friend class Graph;
+
+   public:
+    const N& Source() const { return frozen_->Node(src_); }
+
+    bool IsReachable(const N& dst) const;
+
+    E Distance(const N& dst) const;
+
+    // nodes on a shortest path from the src to dst, both included, empty if dst is unreachable
+    std::vector<std::reference_wrapper<const N>> Path(const N& dst) const;
+
+   private:
+    shortest_paths(std::shared_ptr<const snapshot> frozen, node_id src);
+
+    // path from the src to an id of the snapshot
+    std::vector<std::reference_wrapper<const N>> PathTo(node_id dst) const;
+
+    // parents_[src_] is src_, unreached nodes have parent no_node and no meaningful distance
+    std::shared_ptr<const snapshot> frozen_;
+    node_id src_;
+    std::vector<E> distances_;
+    std::vector<node_id> parents_;
+  };
+
+  // result of AllPairsShortestPaths(), the distance between every pair of nodes, which keeps its
+  // snapshot like shortest_paths
+  class distance_table {
+    // friend for outer class filling the table
+    friend class Graph;
+
+   public:
+    bool IsReachable(const N& src, const N& dst) const;
+
+    E Distance(const N& src, const N& dst) const;
+
+    // distance of unreachable pairs in Distances(), infinity if E has one, else half its maximum,
+    // so two of them add up without overflow
+    static constexpr E Unreachable() noexcept {
+      return std::numeric_limits<E>::has_infinity ? std::numeric_limits<E>::infinity()
+                                                  : std::numeric_limits<E>::max() / 2;
+    }
+
+    // the distances in rows by ids of the snapshot, from src to dst at src * NodeCount() + dst
+    const snapshot& Snapshot() const noexcept { return *frozen_; }
+
+    const std::vector<E>& Distances() const noexcept { return distances_; }
+
+   private:
+    explicit distance_table(std::shared_ptr<const snapshot> frozen);
+
+    std::shared_ptr<const snapshot> frozen_;
+    std::vector<E> distances_;
+  };
+
+  // result of BreadthFirstSearch(), the depth of every node and a breadth first tree from one
+  // src, which keeps its snapshot like shortest_paths
+  class bfs_tree {
+    // friend for outer class filling the tree
+    friend class Graph;
+
+   public:
+    const N& Source() const { return frozen_->Node(src_); }
+
+    bool IsReachable(const N& dst) const;
+
+    // number of edges on a shortest path from the src to dst
+    std::size_t Depth(const N& dst) const;
+
+    // nodes on a path of Depth(dst) edges from the src to dst, empty if dst is unreachable
+    std::vector<std::reference_wrapper<const N>> Path(const N& dst) const;
+
+    // the arrays of the tree, indexed by ids of the snapshot, for reports over every node
+    // unreached nodes have depth and parent no_node, the parent of the src is itself
+    const snapshot& Snapshot() const noexcept { return *frozen_; }
+
+    const std::vector<node_id>& Depths() const noexcept { return depths_; }
+
+    const std::vector<node_id>& Parents() const noexcept { return parents_; }
+
+   private:
+    bfs_tree(std::shared_ptr<const snapshot> frozen, node_id src);
+
+    std::shared_ptr<const snapshot> frozen_;
+    node_id src_;
+    std::vector<node_id> depths_;
+    std::vector<node_id> parents_;
+  };
+
+  // result of PageRank(), a rank per node, which keeps its snapshot like shortest_paths
+  class page_ranks {
+    // friend for outer class filling the ranks
+    friend class Graph;
+
+   public:
+    // ranks are positive and sum to 1
+    double Rank(const N& node) const;
+
+    std::size_t Iterations() const noexcept { return iterations_; }
+
+    // if the ranks changed by less than the tolerance in the last iteration
+    bool Converged() const noexcept { return converged_; }
+
+    // the ranks indexed by ids of the snapshot, for reports over every node
+    const snapshot& Snapshot() const noexcept { return *frozen_; }
+
+    const std::vector<double>& Ranks() const noexcept { return ranks_; }
+
+   private:
+    explicit page_ranks(std::shared_ptr<const snapshot> frozen);
+
+    std::shared_ptr<const snapshot> frozen_;
+    std::vector<double> ranks_;
+    std::size_t iterations_ = 0;
+    bool converged_ = false;
+  };
+
+  // result of ClusteringCoefficients(), triangles and local clustering coefficient per node, which
+  // keeps its snapshot like shortest_paths
+  class clustering {
+    // friend for outer class filling the counts
+    friend class Graph;
+
+   public:
+    // number of triangles through node
+    std::size_t Triangles(const N& node) const;
+
+    // fraction of pairs of neighbours of node which are neighbours, 0 for less than two
+    double Coefficient(const N& node) const;
+
+    // mean of the coefficients of every node
+    double AverageCoefficient() const noexcept;
+
+    // the counts and coefficients indexed by ids of the snapshot, for reports over every node
+    const snapshot& Snapshot() const noexcept { return *frozen_; }
+
+    const std::vector<std::size_t>& TriangleCounts() const noexcept { return triangles_; }
+
+    const std::vector<double>& Coefficients() const noexcept { return coefficients_; }
+
+   private:
+    explicit clustering(std::shared_ptr<const snapshot> frozen);
+
+    std::shared_ptr<const snapshot> frozen_;
+    std::vector<std::size_t> triangles_;
+    std::vector<double> coefficients_;
+  };
+
+  // result of CoreDecomposition(), the core number of every node, which keeps its snapshot like
+  // shortest_paths
+  class cores {
+    // friend for outer class filling the core numbers
+    friend class Graph;
+
+   public:
+    // largest k such that node is in the k-core, the largest subgraph where every node has at
+    // least k neighbours
+    std::size_t CoreNumber(const N& node) const;
+
+    // largest core number of any node
+    std::size_t Degeneracy() const noexcept { return degeneracy_; }
+
+    // nodes of the k-core, in sorted order
+    std::vector<std::reference_wrapper<const N>> Core(std::size_t k) const;
+
+    // the core numbers indexed by ids of the snapshot, for reports over every node
+    const snapshot& Snapshot() const noexcept { return *frozen_; }
+
+    const std::vector<std::size_t>& CoreNumbers() const noexcept { return core_numbers_; }
+
+   private:
+    explicit cores(std::shared_ptr<const snapshot> frozen);
+
+    std::shared_ptr<const snapshot> frozen_;
+    std::vector<std::size_t> core_numbers_;
+    std::size_t degeneracy_ = 0;
+  };
+
+  // result of Betweenness(), the betweenness centrality of every node, which keeps its snapshot
+  // like shortest_paths
+  class centrality {
+    // friend for outer class filling the scores
+    friend class Graph;
+
+   public:
+    // sum over pairs of other nodes src and dst of the fraction of shortest paths from src to dst
+    // through node, estimated from the sampled srcs if sampled
+    double Score(const N& node) const;
+
+    // the scores indexed by ids of the snapshot, for reports over every node
+    const snapshot& Snapshot() const noexcept { return *frozen_; }
+
+    const std::vector<double>& Scores() const noexcept { return scores_; }
+
+   private:
+    explicit centrality(std::shared_ptr<const snapshot> frozen);
+
+    std::shared_ptr<const snapshot> frozen_;
+    std::vector<double> scores_;
+  };
+
+  // result of MaxFlow(), the value of a maximum flow and a minimum cut, which keeps its snapshot
+  // like shortest_paths
+  class flow {
+    // friend for outer class filling the cut
+    friend class Graph;
+
+   public:
+    E Value() const noexcept { return value_; }
+
+    // if node is on the source side of the minimum cut, which is the set of nodes still reachable
+    // from source once the flow is maximum
+    bool IsSourceSide(const N& node) const;
+
+    // every edge from the source side to the sink side, parallel edges each, their weights sum to
+    // Value()
+    const std::vector<typename snapshot::const_iterator>& CutEdges() const noexcept {
+      return cut_edges_;
+    }
+
+    // the sides indexed by ids of the snapshot, 1 on the source side, for reports over every node
+    const snapshot& Snapshot() const noexcept { return *frozen_; }
+
+    const std::vector<unsigned char>& SourceSide() const noexcept { return source_side_; }
+
+   private:
+    explicit flow(std::shared_ptr<const snapshot> frozen);
+
+    std::shared_ptr<const snapshot> frozen_;
+    E value_{};
+    std::vector<unsigned char> source_side_;
+    std::vector<typename snapshot::const_iterator> cut_edges_;
+  };
+
+  // result of StronglyConnectedComponents() and WeaklyConnectedComponents(), a component label
+  // per node, which keeps its snapshot like shortest_paths
+  class components {
+    // friend for outer class filling the labels
+    friend class Graph;
+
+   public:
+    std::size_t Count() const noexcept { return count_; }
+
+    // label of the component of node, from 0 to Count() - 1
+    node_id Label(const N& node) const;
+
+    bool SameComponent(const N& a, const N& b) const { return Label(a) == Label(b); }
+
+    // the labels indexed by ids of the snapshot, for reports over every node
+    const snapshot& Snapshot() const noexcept { return *frozen_; }
+
+    const std::vector<node_id>& Labels() const noexcept { return labels_; }
+
+   private:
+    explicit components(std::shared_ptr<const snapshot> frozen);
+
+    std::shared_ptr<const snapshot> frozen_;
+    std::size_t count_ = 0;
+    std::vector<node_id> labels_;
+  };
+
+  Graph() = default;
+
+  // construct from any input range of nodes, or of {src, dst, weight} edge tuples
+  // edges are bulk loaded in O(E log E), the edge sort is skipped if the range is already sorted
+  template <typename InputIt, typename = typename std::iterator_traits<InputIt>::value_type>
+  Graph<N, E>(InputIt begin, InputIt end);
 
   Graph<N, E>(std::initializer_list<N>);
 
@@ -86,8 +596,16 @@ class Graph {
 
   bool InsertNode(const N& val);
 
+  bool InsertNode(N&& val);
+
+  // construct the node from args, then insert it
+  template <typename... Args>
+  bool EmplaceNode(Args&&... args);
+
   bool InsertEdge(const N& src, const N& dst, const E& w);
 
+  bool InsertEdge(const N& src, const N& dst, E&& w);
+
   bool DeleteNode(const N&);
 
   bool Replace(const N& oldData, const N& newData);
@@ -104,10 +622,128 @@ class Graph {
 
   std::vector<N> GetConnected(const N& src) const;
 
+  // nodes with an edge to dst, in sorted order
+  std::vector<N> GetIncoming(const N& dst) const;
+
   std::vector<E> GetWeights(const N& src, const N& dst) const;
 
+  // views of the same sequences as GetNodes(), GetConnected() and GetWeights()
+  // nothing is copied or allocated, the views are read directly from the sorted storage
+  nodes_view GetNodesView() const noexcept;
+
+  connected_view GetConnectedView(const N& src) const;
+
+  weights_view GetWeightsView(const N& src, const N& dst) const;
+
+  // lazy breadth and depth first traversals from src, read directly from the sorted storage
+  // nodes are yielded one at a time, so a caller can stop early without paying for the rest
+  traversal Bfs(const N& src) const;
+
+  traversal Dfs(const N& src) const;
+
   const_iterator find(const N&, const N&, const E&) const;
 
+  // build a snapshot of the current nodes and edges in O(V + E)
+  snapshot Freeze() const;
+
+  // Dijkstra from src, E must be arithmetic and the reached weights must not be negative
+  // out-edges are read contiguously from a snapshot, which is cached until the graph changes
+  shortest_paths ShortestPaths(const N& src) const;
+
+  // nodes on a shortest path from src to dst, empty if dst is unreachable
+  // a bidirectional Dijkstra, searching out-edges from src and in-edges from dst until they meet
+  // after BuildPathIndex() the search runs on the path index instead, unless the graph is too
+  // dense to contract well
+  std::vector<std::reference_wrapper<const N>> ShortestPath(const N& src, const N& dst) const;
+
+  // nodes on a shortest path from src to dst by A* search, empty if dst is unreachable
+  // heuristic(node) estimates the distance from node to dst, and must be consistent, never more
+  // than the weight of an edge plus the estimate at its dst, so settled nodes are never reopened
+  // the open heap and closed bitmap are kept per thread between calls, so a search allocates
+  // nothing but its path, heuristic must not call AStar() itself
+  template <typename Heuristic>
+  std::vector<std::reference_wrapper<const N>>
+  AStar(const N& src, const N& dst, Heuristic heuristic) const;
+
+  // distances between every pair of nodes, by Floyd-Warshall on a matrix of NodeCount()^2
+  // distances, for small dense graphs, negative weights are fine but a negative cycle throws
+  // the matrix is relaxed in tiles that fit in cache, tiles of a round are split across up to
+  // threads threads of the shared pool, all if 0
+  // integer distances must stay below a quarter of the maximum of E
+  distance_table AllPairsShortestPaths(std::size_t threads = 0) const;
+
+  // breadth first search from src on up to threads threads of the shared pool, all if 0
+  // direction-optimizing, a level is expanded top-down from the frontier while it is small, and
+  // bottom-up, by looking for a parent of every unreached node in the frontier, once it is large
+  bfs_tree BreadthFirstSearch(const N& src, std::size_t threads = 0) const;
+
+  // if there is a path from src to dst, every node reaches itself
+  // answered from a ReachabilityIndex built on first use in O(V + E), which most pairs need no
+  // search on, and kept by changes that can't change reachability, new nodes, edges between
+  // nodes that already reach and erasing one of parallel edges, other changes drop it
+  bool IsReachable(const N& src, const N& dst) const;
+
+  // strongly connected components by an iterative Tarjan, in O(V + E) without recursion
+  // labels follow a topological order of the components, edges never go to a smaller label
+  components StronglyConnectedComponents() const;
+
+  // components when edge directions are ignored, on up to threads threads, all if 0
+  // Afforest, a lock-free union-find first links a couple of edges per node, then only the
+  // edges of nodes outside the largest component, labels follow the smallest node of components
+  components WeaklyConnectedComponents(std::size_t threads = 0) const;
+
+  // PageRank with weighted edges, a node passes its rank to its dsts in proportion to the weights
+  // of its out-edges, nodes without out-edges pass it to every node
+  // iterates until the ranks change by less than tolerance in total, at most max_iterations
+  // times, E must be arithmetic and weights must not be negative
+  // each iteration pulls ranks along the in-edges like Multiply(), on up to threads threads
+  page_ranks PageRank(double damping = 0.85, double tolerance = 1e-6,
+                      std::size_t max_iterations = 100, std::size_t threads = 0) const;
+
+  // number of triangles when edge directions are ignored, parallel edges and self loops don't
+  // count, on up to threads threads, all if 0
+  // each triangle is found once, from its node of least degree, by intersecting sorted lists of
+  // the neighbours of higher degree
+  std::size_t CountTriangles(std::size_t threads = 0) const;
+
+  // triangles through every node and local clustering coefficients, with edges taken like
+  // CountTriangles()
+  clustering ClusteringCoefficients(std::size_t threads = 0) const;
+
+  // k-core decomposition when edge directions are ignored, parallel edges and self loops don't
+  // count, by peeling nodes in order of degree from buckets in O(V + E)
+  cores CoreDecomposition() const;
+
+  // betweenness centrality by Brandes' algorithm, shortest paths count edges, or add weights if
+  // weighted, in which case E must be arithmetic and weights must not be negative
+  // parallel edges count once, at their lightest weight, and self loops don't count
+  // a search runs from every src, or from samples pseudo random srcs with the scores scaled up,
+  // spread over up to threads threads, all if 0, each with its own scores, summed at the end
+  centrality Betweenness(bool weighted = false, std::size_t samples = 0,
+                         std::size_t threads = 0) const;
+
+  // maximum flow from source to sink by Dinic's algorithm, weights are capacities, so E must be
+  // arithmetic and weights must not be negative, parallel edges add up and self loops don't count
+  // throw if source or sink doesn't exist, or if they are the same node
+  flow MaxFlow(const N& source, const N& sink) const;
+
+  // edges of a minimum spanning forest, with edges taken as undirected, by Kruskal's algorithm
+  // the edges are sorted by weight across up to threads threads of the shared pool, all if 0
+  // the edges are returned lightest first, they stay valid until they are erased
+  std::vector<const_iterator> MinimumSpanningForest(std::size_t threads = 0) const;
+
+  // every node, each before the nodes it has edges to, by Kahn's algorithm
+  // throw if the graph has a cycle, which FindCycle() returns
+  std::vector<std::reference_wrapper<const N>> TopologicalOrder() const;
+
+  // nodes of some cycle in edge order, its first node repeated at the end, empty if acyclic
+  std::vector<std::reference_wrapper<const N>> FindCycle() const;
+
+  // build a contraction hierarchy of the graph for ShortestPath(), worth it when many paths are
+  // asked of a graph that rarely changes, E must be arithmetic and weights must not be negative
+  // the index is dropped by every change to the graph, and rebuilt by the next ShortestPath()
+  void BuildPathIndex();
+
   bool erase(const N& src, const N& dst, const E& w);
 
   const_iterator erase(const_iterator it);
@@ -137,7 +773,7 @@ class Graph {
     // compare nodes
     for (auto lit = lhs.nodes_.begin(), rit = rhs.nodes_.begin(); lit != lhs.nodes_.end();
          ++lit, ++rit) {
-      if (**lit != **rit) {
+      if ((*lit)->value != (*rit)->value) {
         return false;
       }
     }
@@ -147,8 +783,9 @@ class Graph {
          lit != lhs.connections_.end(); ++lit, ++rit) {
       const connection& lconn = *lit;
       const connection& rconn = *rit;
-      if (*std::get<0>(lconn) != *std::get<0>(rconn) ||
-          *std::get<1>(lconn) != *std::get<1>(rconn) || std::get<2>(lconn) != std::get<2>(rconn)) {
+      if (std::get<0>(lconn)->value != std::get<0>(rconn)->value ||
+          std::get<1>(lconn)->value != std::get<1>(rconn)->value ||
+          std::get<2>(lconn) != std::get<2>(rconn)) {
         return false;
       }
     }
@@ -162,12 +799,13 @@ class Graph {
   }
 
   friend std::ostream& operator<<(std::ostream& out, const gdwg::Graph<N, E>& graph) {
-    for (const auto& src : graph.GetNodes()) {
-      out << src << " (\n";
-      for (const auto& dst : graph.GetConnected(src)) {
-        for (const E& weight : graph.GetWeights(src, dst)) {
-          out << "  " << dst << " | " << weight << "\n";
-        }
+    // nodes_ and connections_ are both sorted by src, so they are walked together in one pass
+    // nothing is copied, out buffers the text until the final flush
+    auto conn = graph.connections_.begin();
+    for (const auto& src : graph.nodes_) {
+      out << src->value << " (\n";
+      for (; conn != graph.connections_.end() && std::get<0>(*conn) == src.get(); ++conn) {
+        out << "  " << std::get<1>(*conn)->value << " | " << std::get<2>(*conn) << '\n';
       }
       out << ")\n";
     }
@@ -182,46 +820,285 @@ class Graph {
     using is_transparent = void;
 
     // comparisons for node_ptr
-    bool operator()(const node_ptr& lhs, const node_ptr& rhs) const { return *lhs < *rhs; }
+    bool operator()(const node_ptr& lhs, const node_ptr& rhs) const {
+      return lhs->value < rhs->value;
+    }
+
+    bool operator()(const node_ptr& lhs, const N& rhs) const { return lhs->value < rhs; }
+
+    bool operator()(const N& lhs, const node_ptr& rhs) const { return lhs < rhs->value; }
+
+    // comparisons between a connection and a {src}, {src, dst} or {src, dst, weight} key
+    // only the leading fields are compared, so equal_range() on a key yields all of its edges
+    bool operator()(const connection& lhs, const std::tuple<const N&>& rhs) const {
+      return std::get<0>(lhs)->value < std::get<0>(rhs);
+    }
+
+    bool operator()(const std::tuple<const N&>& lhs, const connection& rhs) const {
+      return std::get<0>(lhs) < std::get<0>(rhs)->value;
+    }
+
+    bool operator()(const connection& lhs, const std::tuple<const N&, const N&>& rhs) const {
+      if (std::get<0>(lhs)->value < std::get<0>(rhs)) {
+        return true;
+      } else if (std::get<0>(rhs) < std::get<0>(lhs)->value) {
+        return false;
+      } else {
+        return std::get<1>(lhs)->value < std::get<1>(rhs);
+      }
+    }
 
-    bool operator()(const node_ptr& lhs, const N& rhs) const { return *lhs < rhs; }
+    bool operator()(const std::tuple<const N&, const N&>& lhs, const connection& rhs) const {
+      if (std::get<0>(lhs) < std::get<0>(rhs)->value) {
+        return true;
+      } else if (std::get<0>(rhs)->value < std::get<0>(lhs)) {
+        return false;
+      } else {
+        return std::get<1>(lhs) < std::get<1>(rhs)->value;
+      }
+    }
 
-    bool operator()(const N& lhs, const node_ptr& rhs) const { return lhs < *rhs; }
+    bool operator()(const connection& lhs,
+                    const std::tuple<const N&, const N&, const E&>& rhs) const {
+      if ((*this)(lhs, std::tie(std::get<0>(rhs), std::get<1>(rhs)))) {
+        return true;
+      } else if ((*this)(std::tie(std::get<0>(rhs), std::get<1>(rhs)), lhs)) {
+        return false;
+      } else {
+        return std::get<2>(lhs) < std::get<2>(rhs);
+      }
+    }
+
+    bool operator()(const std::tuple<const N&, const N&, const E&>& lhs,
+                    const connection& rhs) const {
+      if ((*this)(std::tie(std::get<0>(lhs), std::get<1>(lhs)), rhs)) {
+        return true;
+      } else if ((*this)(rhs, std::tie(std::get<0>(lhs), std::get<1>(lhs)))) {
+        return false;
+      } else {
+        return std::get<2>(lhs) < std::get<2>(rhs);
+      }
+    }
 
     // comparison between connections
     // first compare src, then dst, finally weight
+    // nodes are interned, so the same node is always the same pointer and needs no dereference
     bool operator()(const connection& lhs, const connection& rhs) const {
-      if (*std::get<0>(lhs) < *std::get<0>(rhs)) {
-        return true;
-      } else if (*std::get<0>(lhs) > *std::get<0>(rhs)) {
-        return false;
+      if (std::get<0>(lhs) != std::get<0>(rhs)) {
+        return std::get<0>(lhs)->value < std::get<0>(rhs)->value;
+      } else if (std::get<1>(lhs) != std::get<1>(rhs)) {
+        return std::get<1>(lhs)->value < std::get<1>(rhs)->value;
       } else {
-        if (*std::get<1>(lhs) < *std::get<1>(rhs)) {
-          return true;
-        } else if (*std::get<1>(lhs) > *std::get<1>(rhs)) {
-          return false;
-        } else {
-          return std::get<2>(lhs) < std::get<2>(rhs);
-        }
+        return std::get<2>(lhs) < std::get<2>(rhs);
       }
     }
   };
 
   // underlying data structure
   // all nodes are stored as shared pointers in a set
-  // all edges are stored with src shared_ptr and dst shared_ptr as tuples in a set
+  // all edges are stored with src and dst node pointers as tuples in a set
+  // ids released by deleted nodes are kept for reuse
+  // so every id is below nodes_.size() + free_ids_.size()
   std::set<node_ptr, compare> nodes_;
   std::set<connection, compare> connections_;
+  std::vector<node_id> free_ids_;
+
+  // reverse index of connections_, every edge is also stored here as {dst, src, weight}
+  // so the in-edges of a node are contiguous, like its out-edges in connections_
+  std::set<connection, compare> incoming_;
+
+  // snapshot used by the algorithms, built on first use and dropped by every change
+  mutable std::shared_ptr<const snapshot> frozen_;
+
+  // helper function, return the cached snapshot, building it if the graph changed
+  std::shared_ptr<const snapshot> Frozen() const;
+
+  // path index of ShortestPath(), once BuildPathIndex() is called it is kept up to date lazily
+  // like the snapshot
+  bool use_path_index_ = false;
+  mutable std::shared_ptr<const ContractionHierarchy<E>> path_index_;
+
+  // helper function, return the cached path index, building it if the graph changed, caller
+  // names the public function in the error on negative weights
+  std::shared_ptr<const ContractionHierarchy<E>> PathIndex(const char* caller) const;
+
+  // reachability index of IsReachable() with the snapshot its ids are from, so it can outlive
+  // the snapshot cache, nodes inserted since it was built are not in it and have no edges
+  struct reachability {
+    std::shared_ptr<const snapshot> frozen;
+    ReachabilityIndex index;
+  };
+  mutable std::shared_ptr<const reachability> reachability_;
+
+  // helper function, return the cached reachability index, building it if it was dropped
+  std::shared_ptr<const reachability> Reachability() const;
+
+  // helper function, if the cached reachability index has src reaching dst, false without one
+  bool CachedReachable(const N& src, const N& dst) const;
+
+  // helper function, drop the cached snapshot and indexes after a change, the reachability index
+  // is kept if the change can't change which nodes reach which
+  void Invalidate(bool same_reachability = false) noexcept {
+    frozen_.reset();
+    path_index_.reset();
+    if (!same_reachability) {
+      reachability_.reset();
+    }
+  }
+
+  // helper function, Dijkstra from src on a snapshot, stopping early once dst is settled
+  static shortest_paths Dijkstra(std::shared_ptr<const snapshot> frozen, node_id src, node_id dst);
+
+  // neighbours of every node of a snapshot when edge directions are ignored, sorted without
+  // repeats or the node itself, the neighbours of i are at [offsets[i], offsets[i + 1]) of nodes
+  struct adjacency {
+    std::vector<std::size_t> offsets;
+    std::vector<node_id> nodes;
+  };
+
+  // helper function, build the adjacency of a snapshot, on up to threads threads
+  static adjacency Undirected(const snapshot& graph, std::size_t threads);
+
+  // helper function, keep the neighbours of higher degree, ties broken by id, which orients every
+  // edge of the adjacency once and keeps the lists sorted
+  static adjacency HigherDegree(const adjacency& graph, std::size_t threads);
+
+  // helper function, the number of nodes of every degree from 0 to the largest
+  static std::vector<std::size_t> Histogram(const std::vector<std::size_t>& degrees);
+
+  // helper function, nodes on the path from src to dst of a tree given by parents, or empty
+  static std::vector<std::reference_wrapper<const N>>
+  TreePath(const snapshot& graph, const std::vector<node_id>& parents, node_id src, node_id dst);
+
+  // helper function, ids on a shortest path from src to dst of a snapshot, or empty
+  static std::vector<node_id> BidirectionalDijkstra(const snapshot& graph, node_id src,
+                                                    node_id dst);
+
+  // helper function, create a node with the next free id
+  node_ptr MakeNode(N val);
 
   // helper function, return if the edge exist
   bool IsEdge(const N& src, const N& dst, const E& w) const noexcept;
 
-  // helper function, return if node is in a connection
-  bool NodeInConnection(const connection& conn, const N& node) const noexcept;
+  // helper function, bulk load sorted and deduplicated edges into an empty graph
+  void LoadEdges(std::vector<std::tuple<N, N, E>> edges);
+
+  // helper function, shared by InsertNode overloads, val is copied or moved into the node
+  template <typename V>
+  bool AddNode(V&& val);
+
+  // helper function, shared by InsertEdge overloads, w is copied or moved into the edge
+  template <typename W>
+  bool AddEdge(const N& src, const N& dst, W&& w);
+
+  // helper function, insert a connection and its reversed record
+  void InsertConnection(connection&& conn);
+
+  // helper function, erase every connection of node and their reversed records
+  void EraseConnections(const N& node);
+
+  // helper function, swap src and dst of a connection
+  static connection Reversed(const connection& conn) {
+    return {std::get<1>(conn), std::get<0>(conn), std::get<2>(conn)};
+  }
+
+ public:
+  // single pass input range of the nodes reachable from a src, each yielded once, in order of
+  // depth for Bfs() and in preorder for Dfs(), with the edge it was reached by
+  // the out-edges of a node are only read once the traversal moves past it, and like a view it
+  // is invalidated when the graph changes
+  // defined here, as its positions in the edges depend on compare
+  class traversal {
+    // friend for outer class starting the traversal
+    friend class Graph;
+
+   public:
+    class const_iterator {
+      // friend for traversal constructing the iterator
+      friend class traversal;
+
+     public:
+      using iterator_category = std::input_iterator_tag;
+      using value_type = N;
+      using reference = const N&;
+      using pointer = const N*;
+      using difference_type = std::ptrdiff_t;
+
+      reference operator*() const { return traversal_->Current().at->value; }
+
+      pointer operator->() const { return &**this; }
+
+      // number of edges on the way from the src to the node, 0 for the src
+      std::size_t Depth() const { return traversal_->Current().depth; }
+
+      // the edge the node was reached by, from the node it was reached from
+      // throw for the src, which was not reached by an edge
+      std::tuple<const N&, const N&, const E&> Edge() const;
+
+      // resume the traversal up to the next node
+      const_iterator& operator++() {
+        traversal_->Advance();
+        return *this;
+      }
+
+      // iterators are equal once both are at the end, a traversal has one position
+      friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) {
+        return lhs.AtEnd() == rhs.AtEnd();
+      }
+
+      friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) {
+        return lhs.AtEnd() != rhs.AtEnd();
+      }
+
+     private:
+      explicit const_iterator(traversal* traversal) : traversal_{traversal} {}
+
+      bool AtEnd() const noexcept { return !traversal_ || traversal_->visits_.empty(); }
+
+      traversal* traversal_;
+    };
+
+    // the current position, a traversal resumes where it was left
+    const_iterator begin() { return const_iterator{this}; }
+
+    const_iterator end() { return const_iterator{nullptr}; }
+
+   private:
+    using edge_iterator = typename std::set<connection, compare>::const_iterator;
+
+    // a node with the edge it was reached by, null for the src, and for Dfs() its out-edges
+    // left to follow
+    struct visit {
+      const node* at;
+      const connection* edge;
+      std::size_t depth;
+      edge_iterator next;
+      edge_iterator last;
+    };
+
+    traversal(const std::set<connection, compare>& connections, const node* src,
+              std::size_t ids, bool depth_first);
+
+    // the queue of Bfs() yields from the front, the stack of Dfs() from the back
+    const visit& Current() const { return depth_first_ ? visits_.back() : visits_.front(); }
+
+    // helper function, mark a node seen, return if it wasn't before
+    bool See(const node* at);
+
+    // helper function, move to the next node, or the end
+    void Advance();
+
+    // seen nodes are marked by id
+    const std::set<connection, compare>* connections_;
+    bool depth_first_;
+    std::vector<std::uint64_t> seen_;
+    std::deque<visit> visits_;
+  };
 };
 
 }  // namespace gdwg
 
 #include "assignments/dg/graph.tpp"
+#include "assignments/dg/graph_algorithms.tpp"
 
 #endif  // ASSIGNMENTS_DG_GRAPH_H_
@@ -1,25 +1,17 @@
 #include <algorithm>
 
-// typename needed before vector: https://stackoverflow.com/a/20934322/9494810
 template <typename N, typename E>
-gdwg::Graph<N, E>::Graph(typename std::vector<N>::const_iterator begin,
-                         typename std::vector<N>::const_iterator end) {
-  // add all nodes
-  for (auto it = begin; it != end; ++it) {
-    InsertNode(*it);
-  }
-}
-
-template <typename N, typename E>
-gdwg::Graph<N, E>::Graph(typename std::vector<std::tuple<N, N, E>>::const_iterator begin,
-                         typename std::vector<std::tuple<N, N, E>>::const_iterator end) {
-  for (auto it = begin; it != end; ++it) {
-    // add nodes if not exist
-    InsertNode(std::get<0>(*it));
-    InsertNode(std::get<1>(*it));
-
-    // add edge if not exist
-    InsertEdge(std::get<0>(*it), std::get<1>(*it), std::get<2>(*it));
+template <typename InputIt, typename>
+gdwg::Graph<N, E>::Graph(InputIt begin, InputIt end) {
+  if constexpr (std::is_convertible<typename std::iterator_traits<InputIt>::value_type,
+                                    std::tuple<N, N, E>>::value) {
+    // range of edges, add the nodes and edges in one pass
+    LoadEdges(std::vector<std::tuple<N, N, E>>(begin, end));
+  } else {
+    // range of nodes, add all nodes
+    for (auto it = begin; it != end; ++it) {
+      InsertNode(*it);
+    }
   }
 }
 
@@ -33,9 +25,15 @@ gdwg::Graph<N, E>::Graph(std::initializer_list<N> init_nodes) {
 
 template <typename N, typename E>
 gdwg::Graph<N, E>::Graph(const gdwg::Graph<N, E>& graph) {
-  // copy all things
+  // copy all things, nodes are shared with the other graph
   nodes_ = graph.nodes_;
   connections_ = graph.connections_;
+  incoming_ = graph.incoming_;
+  frozen_ = graph.frozen_;
+  use_path_index_ = graph.use_path_index_;
+  path_index_ = graph.path_index_;
+  reachability_ = graph.reachability_;
+  free_ids_ = graph.free_ids_;
 }
 
 template <typename N, typename E>
@@ -43,13 +41,25 @@ gdwg::Graph<N, E>::Graph(gdwg::Graph<N, E>&& graph) noexcept {
   // move all things
   nodes_ = std::move(graph.nodes_);
   connections_ = std::move(graph.connections_);
+  incoming_ = std::move(graph.incoming_);
+  frozen_ = std::move(graph.frozen_);
+  use_path_index_ = graph.use_path_index_;
+  path_index_ = std::move(graph.path_index_);
+  reachability_ = std::move(graph.reachability_);
+  free_ids_ = std::move(graph.free_ids_);
 }
 
 template <typename N, typename E>
 gdwg::Graph<N, E>& gdwg::Graph<N, E>::operator=(const gdwg::Graph<N, E>& graph) {
-  // copy all things
+  // copy all things, nodes are shared with the other graph
   nodes_ = graph.nodes_;
   connections_ = graph.connections_;
+  incoming_ = graph.incoming_;
+  frozen_ = graph.frozen_;
+  use_path_index_ = graph.use_path_index_;
+  path_index_ = graph.path_index_;
+  reachability_ = graph.reachability_;
+  free_ids_ = graph.free_ids_;
   return *this;
 }
 
@@ -58,24 +68,79 @@ gdwg::Graph<N, E>& gdwg::Graph<N, E>::operator=(gdwg::Graph<N, E>&& graph) noexc
   // move all things
   nodes_ = std::move(graph.nodes_);
   connections_ = std::move(graph.connections_);
+  incoming_ = std::move(graph.incoming_);
+  frozen_ = std::move(graph.frozen_);
+  use_path_index_ = graph.use_path_index_;
+  path_index_ = std::move(graph.path_index_);
+  reachability_ = std::move(graph.reachability_);
+  free_ids_ = std::move(graph.free_ids_);
   return *this;
 }
 
 template <typename N, typename E>
 bool gdwg::Graph<N, E>::InsertNode(const N& val) {
-  if (IsNode(val)) {
+  // val is copied once, into the node
+  return AddNode(val);
+}
+
+template <typename N, typename E>
+bool gdwg::Graph<N, E>::InsertNode(N&& val) {
+  // val is moved into the node
+  return AddNode(std::move(val));
+}
+
+template <typename N, typename E>
+template <typename... Args>
+bool gdwg::Graph<N, E>::EmplaceNode(Args&&... args) {
+  // the value is built once, then moved into the node
+  return AddNode(N(std::forward<Args>(args)...));
+}
+
+template <typename N, typename E>
+template <typename V>
+bool gdwg::Graph<N, E>::AddNode(V&& val) {
+  // the position found by the search is reused as the insertion hint
+  auto it = nodes_.lower_bound(val);
+  if (it != nodes_.end() && !(val < (*it)->value)) {
     // already exist
     return false;
   } else {
-    // not exist, add to nodes
-    nodes_.insert(std::make_shared<N>(val));
+    // not exist, add to nodes, a node without edges reaches no other node
+    nodes_.insert(it, MakeNode(std::forward<V>(val)));
+    Invalidate(true);
     return true;
   }
 }
 
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::node_ptr gdwg::Graph<N, E>::MakeNode(N val) {
+  // reuse a released id first, otherwise every id below nodes_.size() is taken
+  node_id id = static_cast<node_id>(nodes_.size());
+  if (!free_ids_.empty()) {
+    id = free_ids_.back();
+    free_ids_.pop_back();
+  }
+  return std::make_shared<const node>(node{std::move(val), id});
+}
+
 template <typename N, typename E>
 bool gdwg::Graph<N, E>::InsertEdge(const N& src, const N& dst, const E& w) {
-  if (!IsNode(src) || !IsNode(dst)) {
+  // w is copied once, into the edge
+  return AddEdge(src, dst, w);
+}
+
+template <typename N, typename E>
+bool gdwg::Graph<N, E>::InsertEdge(const N& src, const N& dst, E&& w) {
+  // w is moved into the edge
+  return AddEdge(src, dst, std::move(w));
+}
+
+template <typename N, typename E>
+template <typename W>
+bool gdwg::Graph<N, E>::AddEdge(const N& src, const N& dst, W&& w) {
+  auto src_it = nodes_.find(src);
+  auto dst_it = nodes_.find(dst);
+  if (src_it == nodes_.end() || dst_it == nodes_.end()) {
     // not both nodes exist
     throw std::runtime_error(
         "Cannot call Graph::InsertEdge when either src or dst node does not exist");
@@ -84,7 +149,7 @@ bool gdwg::Graph<N, E>::InsertEdge(const N& src, const N& dst, const E& w) {
     return false;
   } else {
     // can insert this edge
-    connections_.insert(std::make_tuple(*nodes_.find(src), *nodes_.find(dst), w));
+    InsertConnection(std::make_tuple(src_it->get(), dst_it->get(), std::forward<W>(w)));
     return true;
   }
 }
@@ -92,11 +157,7 @@ bool gdwg::Graph<N, E>::InsertEdge(const N& src, const N& dst, const E& w) {
 template <typename N, typename E>
 bool gdwg::Graph<N, E>::IsEdge(const N& src, const N& dst, const E& w) const noexcept {
   // edge should have same weight and src and dst
-  return std::find_if(connections_.begin(), connections_.end(),
-                      [&, src, dst, w](connection const& connect) {
-                        return std::get<2>(connect) == w &&
-                               (*(std::get<0>(connect)) == src && *(std::get<1>(connect)) == dst);
-                      }) != connections_.end();
+  return connections_.find(std::tie(src, dst, w)) != connections_.end();
 }
 
 template <typename N, typename E>
@@ -107,17 +168,13 @@ bool gdwg::Graph<N, E>::DeleteNode(const N& node) {
   }
 
   // delete associated edges
-  for (auto it = connections_.begin(); it != connections_.end();) {
-    if (NodeInConnection(*it, node)) {
-      // found a connection that contains the node, erase the connection
-      it = connections_.erase(it);
-    } else {
-      ++it;
-    }
-  }
+  EraseConnections(node);
 
-  // delete node
-  nodes_.erase(nodes_.find(node));
+  // delete node, its id can be reused, its edges are gone, so the others reach the same nodes
+  auto it = nodes_.find(node);
+  free_ids_.push_back((*it)->id);
+  nodes_.erase(it);
+  Invalidate(true);
   return true;
 }
 
@@ -133,26 +190,8 @@ bool gdwg::Graph<N, E>::Replace(const N& oldData, const N& newData) {
     throw std::runtime_error("Cannot call Graph::Replace on a node that doesn't exist");
   }
 
+  // add the new node, then remove the old node along with its edges
   InsertNode(newData);
-  auto newDataPtr = *nodes_.find(newData);
-
-  // change connections that contains oldData
-  std::vector<connection> changed;
-  for (auto it = connections_.begin(); it != connections_.end();) {
-    if (*std::get<0>(*it) == newData) {
-      connection conn = {newDataPtr, std::get<1>(*it), std::get<2>(*it)};
-      it = connections_.erase(it);
-    } else if (*std::get<1>(*it) == newData) {
-      connection conn = {std::get<0>(*it), newDataPtr, std::get<2>(*it)};
-      it = connections_.erase(it);
-    } else {
-      ++it;
-    }
-  }
-  for (auto& conn : changed) {
-    InsertEdge(*std::get<0>(conn), *std::get<1>(conn), std::get<2>(conn));
-  }
-
   DeleteNode(oldData);
 
   return true;
@@ -167,35 +206,35 @@ void gdwg::Graph<N, E>::MergeReplace(const N& oldData, const N& newData) {
   }
 
   // point all oldData in connections to newData
-  auto it_new = nodes_.find(newData);
+  auto new_ptr = nodes_.find(newData)->get();
+  auto old_ptr = nodes_.find(oldData)->get();
 
   // store all changed connection to a temp vector and remove them from connections
   // add these connections from temp vector to this.connections
   // implicitly removes duplications
+  // only the edges of oldData are visited, out-edges first and then in-edges
   std::vector<connection> changed_connections{};
-  for (auto it = connections_.begin(); it != connections_.end();) {
+  auto out = connections_.equal_range(std::tie(oldData));
+  for (auto it = out.first; it != out.second; ++it) {
     connection conn = *it;
-    bool found = false;
-    if (*(std::get<0>(conn)) == oldData) {
-      std::get<0>(conn) = *it_new;
-      found = true;
-    }
-    if (*(std::get<1>(conn)) == oldData) {
-      std::get<1>(conn) = *it_new;
-      found = true;
+    std::get<0>(conn) = new_ptr;
+    if (std::get<1>(conn) == old_ptr) {
+      std::get<1>(conn) = new_ptr;
     }
-    if (found) {
-      // remove this iterator and add back later with modified value
-      changed_connections.push_back(conn);
-      it = connections_.erase(it);
-    } else {
-      ++it;
+    changed_connections.push_back(conn);
+  }
+  auto in = incoming_.equal_range(std::tie(oldData));
+  for (auto it = in.first; it != in.second; ++it) {
+    // self loops were already changed as out-edges
+    if (std::get<1>(*it) != old_ptr) {
+      changed_connections.push_back(std::make_tuple(std::get<1>(*it), new_ptr, std::get<2>(*it)));
     }
   }
+  EraseConnections(oldData);
 
   // add back changed values
   for (auto& conn : changed_connections) {
-    connections_.insert(conn);
+    InsertConnection(std::move(conn));
   }
 
   // oldData is no longer used
@@ -207,6 +246,9 @@ void gdwg::Graph<N, E>::Clear() {
   // clear all things
   nodes_.clear();
   connections_.clear();
+  incoming_.clear();
+  free_ids_.clear();
+  Invalidate();
 }
 
 template <typename N, typename E>
@@ -218,10 +260,7 @@ bool gdwg::Graph<N, E>::IsConnected(const N& src, const N& dst) const {
 
   // only care if src is connected to dst
   // ignore weight
-  return std::find_if(connections_.begin(), connections_.end(),
-                      [&, src, dst](connection const& connect) {
-                        return *(std::get<0>(connect)) == src && *(std::get<1>(connect)) == dst;
-                      }) != connections_.end();
+  return connections_.find(std::tie(src, dst)) != connections_.end();
 }
 
 template <typename N, typename E>
@@ -232,82 +271,249 @@ bool gdwg::Graph<N, E>::IsNode(const N& val) const {
 
 template <typename N, typename E>
 std::vector<N> gdwg::Graph<N, E>::GetNodes() const {
-  // transform all shared node pointers to node and push to vector
-  std::vector<N> node_return;
-  std::transform(nodes_.begin(), nodes_.end(), std::back_inserter(node_return),
-                 [](node_ptr const& node) -> N { return *node; });
-  return node_return;
+  // copy all nodes from the view to vector
+  auto nodes = GetNodesView();
+  return std::vector<N>(nodes.begin(), nodes.end());
 }
 
 template <typename N, typename E>
 std::vector<N> gdwg::Graph<N, E>::GetConnected(const N& src) const {
-  if (!IsNode(src)) {
+  // copy all node connected by src from the view to vector
+  auto connected = GetConnectedView(src);
+  return std::vector<N>(connected.begin(), connected.end());
+}
+
+template <typename N, typename E>
+std::vector<N> gdwg::Graph<N, E>::GetIncoming(const N& dst) const {
+  if (!IsNode(dst)) {
     // node not exist
-    throw std::out_of_range("Cannot call Graph::GetConnected if src doesn't exist in the graph");
+    throw std::out_of_range("Cannot call Graph::GetIncoming if dst doesn't exist in the graph");
   }
 
-  // push all node connected by src to vector
+  // push all node connecting to dst to vector
+  // reversed edges to dst are contiguous and sorted by src, so duplications are adjacent
   std::vector<N> conn_return;
-  for (auto conn : connections_) {
-    if (*std::get<0>(conn) == src) {
-      conn_return.push_back(*std::get<1>(conn));
+  auto range = incoming_.equal_range(std::tie(dst));
+  for (auto it = range.first; it != range.second; ++it) {
+    if (conn_return.empty() || conn_return.back() != std::get<1>(*it)->value) {
+      conn_return.push_back(std::get<1>(*it)->value);
     }
   }
-
-  // sort the vector and remove duplication
-  std::sort(conn_return.begin(), conn_return.end());
-  conn_return.erase(std::unique(conn_return.begin(), conn_return.end()), conn_return.end());
   return conn_return;
 }
 
 template <typename N, typename E>
 std::vector<E> gdwg::Graph<N, E>::GetWeights(const N& src, const N& dst) const {
+  // copy all weight that connects from src to dst from the view to vector
+  auto weights = GetWeightsView(src, dst);
+  return std::vector<E>(weights.begin(), weights.end());
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::nodes_view gdwg::Graph<N, E>::GetNodesView() const noexcept {
+  // nodes are already sorted
+  using iterator = typename nodes_view::iterator;
+  return {iterator{nodes_.begin(), nodes_.end()}, iterator{nodes_.end(), nodes_.end()}};
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::connected_view gdwg::Graph<N, E>::GetConnectedView(const N& src) const {
+  if (!IsNode(src)) {
+    // node not exist
+    throw std::out_of_range("Cannot call Graph::GetConnected if src doesn't exist in the graph");
+  }
+
+  // edges from src are contiguous and sorted by dst, the iterator skips parallel edges
+  using iterator = typename connected_view::iterator;
+  auto range = connections_.equal_range(std::tie(src));
+  return {iterator{range.first, range.second}, iterator{range.second, range.second}};
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::weights_view gdwg::Graph<N, E>::GetWeightsView(const N& src,
+                                                                           const N& dst) const {
   if (!IsNode(src) || !IsNode(dst)) {
     // not both nodes exist
     throw std::out_of_range(
         "Cannot call Graph::GetWeights if src or dst node don't exist in the graph");
   }
 
-  // push all weight that connects from src to dst to vector
-  std::vector<E> weights;
-  for (auto conn : connections_) {
-    if (*std::get<0>(conn) == src && *std::get<1>(conn) == dst) {
-      weights.push_back(std::get<2>(conn));
+  // edges between src and dst are already in increasing order of weight
+  using iterator = typename weights_view::iterator;
+  auto range = connections_.equal_range(std::tie(src, dst));
+  return {iterator{range.first, range.second}, iterator{range.second, range.second}};
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::traversal gdwg::Graph<N, E>::Bfs(const N& src) const {
+  auto it = nodes_.find(src);
+  if (it == nodes_.end()) {
+    // node not exist
+    throw std::out_of_range("Cannot call Graph::Bfs if src doesn't exist in the graph");
+  }
+  return traversal{connections_, it->get(), nodes_.size() + free_ids_.size(), false};
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::traversal gdwg::Graph<N, E>::Dfs(const N& src) const {
+  auto it = nodes_.find(src);
+  if (it == nodes_.end()) {
+    // node not exist
+    throw std::out_of_range("Cannot call Graph::Dfs if src doesn't exist in the graph");
+  }
+  return traversal{connections_, it->get(), nodes_.size() + free_ids_.size(), true};
+}
+
+template <typename N, typename E>
+gdwg::Graph<N, E>::traversal::traversal(const std::set<connection, compare>& connections,
+                                        const node* src, std::size_t ids, bool depth_first)
+  : connections_{&connections}, depth_first_{depth_first}, seen_((ids + 63) / 64, 0) {
+  See(src);
+  auto range = connections_->equal_range(std::tie(src->value));
+  visits_.push_back({src, nullptr, 0, range.first, range.second});
+}
+
+template <typename N, typename E>
+bool gdwg::Graph<N, E>::traversal::See(const node* at) {
+  std::uint64_t bit = std::uint64_t{1} << (at->id % 64);
+  bool seen = seen_[at->id / 64] & bit;
+  seen_[at->id / 64] |= bit;
+  return !seen;
+}
+
+template <typename N, typename E>
+void gdwg::Graph<N, E>::traversal::Advance() {
+  if (!depth_first_) {
+    // queue the unseen dsts of the current node, parallel edges are adjacent, so the first one,
+    // the lightest, is the edge a dst is reached by
+    const visit& current = visits_.front();
+    auto range = connections_->equal_range(std::tie(current.at->value));
+    for (auto it = range.first; it != range.second; ++it) {
+      if (See(std::get<1>(*it))) {
+        visits_.push_back({std::get<1>(*it), &*it, current.depth + 1, {}, {}});
+      }
     }
+    visits_.pop_front();
+    return;
   }
 
-  // sort weight in increasing order
-  std::sort(weights.begin(), weights.end());
-  return weights;
+  // follow the next edge to an unseen dst from the deepest node that has one
+  while (!visits_.empty()) {
+    visit& current = visits_.back();
+    while (current.next != current.last) {
+      const connection& edge = *current.next++;
+      if (See(std::get<1>(edge))) {
+        auto range = connections_->equal_range(std::tie(std::get<1>(edge)->value));
+        visits_.push_back({std::get<1>(edge), &edge, current.depth + 1, range.first, range.second});
+        return;
+      }
+    }
+    visits_.pop_back();
+  }
 }
 
 template <typename N, typename E>
-bool gdwg::Graph<N, E>::NodeInConnection(const connection& conn, const N& node) const noexcept {
-  // if eigher src or dst equals node, return true
-  return *(std::get<0>(conn)) == node || *(std::get<1>(conn)) == node;
+std::tuple<const N&, const N&, const E&>
+gdwg::Graph<N, E>::traversal::const_iterator::Edge() const {
+  const connection* edge = traversal_->Current().edge;
+  if (!edge) {
+    throw std::runtime_error("Cannot call Graph::traversal::Edge on the src of the traversal");
+  }
+  return {std::get<0>(*edge)->value, std::get<1>(*edge)->value, std::get<2>(*edge)};
 }
 
 template <typename N, typename E>
-typename gdwg::Graph<N, E>::const_iterator
-gdwg::Graph<N, E>::find(const N& src, const N& dst, const E& weight) const {
-  // iterate through and reutrn if found
-  for (auto it = cbegin(); it != cend(); ++it) {
-    if (std::get<0>(*it) == src && std::get<1>(*it) == dst && std::get<2>(*it) == weight) {
-      return it;
+void gdwg::Graph<N, E>::LoadEdges(std::vector<std::tuple<N, N, E>> edges) {
+  // sort by {src, dst, weight} unless the input already is, then drop duplicated edges
+  if (!std::is_sorted(edges.begin(), edges.end())) {
+    std::sort(edges.begin(), edges.end());
+  }
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+  // every node is a src or a dst of some edge, collect them in sorted order
+  std::vector<N> values;
+  values.reserve(edges.size());
+  for (const auto& edge : edges) {
+    if (values.empty() || values.back() != std::get<0>(edge)) {
+      values.push_back(std::get<0>(edge));
     }
   }
+  auto srcs_end = values.size();
+  for (const auto& edge : edges) {
+    values.push_back(std::get<1>(edge));
+  }
+  std::sort(values.begin() + srcs_end, values.end());
+  std::inplace_merge(values.begin(), values.begin() + srcs_end, values.end());
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+
+  // nodes arrive in order, so each insertion at the end hint is amortised O(1)
+  std::vector<node_ptr> ptrs;
+  ptrs.reserve(values.size());
+  for (auto& value : values) {
+    ptrs.push_back(MakeNode(std::move(value)));
+    nodes_.insert(nodes_.end(), ptrs.back());
+  }
 
-  // if not found, return cend()
-  return cend();
+  // srcs are visited in order, so they are found by advancing a cursor
+  // dsts are found by binary search on the sorted node pointers
+  auto src_it = ptrs.begin();
+  for (auto& edge : edges) {
+    while ((*src_it)->value < std::get<0>(edge)) {
+      ++src_it;
+    }
+    auto dst_it = std::lower_bound(ptrs.begin(), ptrs.end(), std::get<1>(edge), compare{});
+    auto conn_it =
+        connections_.insert(connections_.end(), std::make_tuple(src_it->get(), dst_it->get(),
+                                                                std::move(std::get<2>(edge))));
+    incoming_.insert(Reversed(*conn_it));
+  }
+}
+
+template <typename N, typename E>
+void gdwg::Graph<N, E>::InsertConnection(connection&& conn) {
+  // keep both indexes in step, the reversed record holds the only copy of the weight
+  // an edge from a node to one it already reaches doesn't change reachability
+  bool same_reachability = CachedReachable(std::get<0>(conn)->value, std::get<1>(conn)->value);
+  incoming_.insert(Reversed(conn));
+  connections_.insert(std::move(conn));
+  Invalidate(same_reachability);
+}
+
+template <typename N, typename E>
+void gdwg::Graph<N, E>::EraseConnections(const N& node) {
+  // out-edges are contiguous in connections_, erase their reversed records one by one
+  auto out = connections_.equal_range(std::tie(node));
+  bool same_reachability = out.first == out.second && incoming_.count(std::tie(node)) == 0;
+  for (auto it = out.first; it != out.second; ++it) {
+    incoming_.erase(Reversed(*it));
+  }
+  connections_.erase(out.first, out.second);
+
+  // in-edges are contiguous in incoming_, self loops are already gone with the out-edges
+  auto in = incoming_.equal_range(std::tie(node));
+  for (auto it = in.first; it != in.second; ++it) {
+    connections_.erase(Reversed(*it));
+  }
+  incoming_.erase(in.first, in.second);
+  Invalidate(same_reachability);
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::const_iterator
+gdwg::Graph<N, E>::find(const N& src, const N& dst, const E& weight) const {
+  // search connections by value, cend() if not found
+  return const_iterator{connections_.find(std::tie(src, dst, weight))};
 }
 
 template <typename N, typename E>
 bool gdwg::Graph<N, E>::erase(const N& src, const N& dst, const E& w) {
-  // try to find the edge
-  auto it = find(src, dst, w);
-  if (it != cend()) {
-    // erase only if found
-    erase(it);
+  // look up the connection by value
+  auto it = connections_.find(std::tie(src, dst, w));
+  if (it != connections_.end()) {
+    // erase only if found, a parallel edge left keeps reachability
+    incoming_.erase(Reversed(*it));
+    connections_.erase(it);
+    Invalidate(connections_.count(std::tie(src, dst)) > 0);
     return true;
   }
 
@@ -318,8 +524,12 @@ bool gdwg::Graph<N, E>::erase(const N& src, const N& dst, const E& w) {
 template <typename N, typename E>
 typename gdwg::Graph<N, E>::const_iterator
 gdwg::Graph<N, E>::erase(typename gdwg::Graph<N, E>::const_iterator it) {
-  // erase and return next iterator
+  // erase and return next iterator, a parallel edge left keeps reachability
+  const N& src = std::get<0>(*it.it_)->value;
+  const N& dst = std::get<1>(*it.it_)->value;
+  incoming_.erase(Reversed(*it.it_));
   auto next_it = connections_.erase(it.it_);
+  Invalidate(connections_.count(std::tie(src, dst)) > 0);
   return const_iterator{next_it};
 }
 
@@ -399,5 +609,127 @@ template <typename N, typename E>
 const typename gdwg::Graph<N, E>::const_iterator::reference gdwg::Graph<N, E>::const_iterator::
 operator*() const {
   // return const refefences
-  return {*std::get<0>(*it_), *std::get<1>(*it_), std::get<2>(*it_)};
+  return {std::get<0>(*it_)->value, std::get<1>(*it_)->value, std::get<2>(*it_)};
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::snapshot gdwg::Graph<N, E>::Freeze() const {
+  snapshot frozen;
+
+  // nodes are renumbered by rank, indexed by their interned ids
+  std::vector<node_id> rank(nodes_.size() + free_ids_.size());
+  frozen.nodes_.reserve(nodes_.size());
+  for (const auto& node : nodes_) {
+    rank[node->id] = static_cast<node_id>(frozen.nodes_.size());
+    frozen.nodes_.push_back(node);
+  }
+
+  // connections are already grouped by src in rank order, and sorted by dst and weight
+  // count the out-degree of each src, then prefix sum the counts to offsets
+  frozen.offsets_.assign(nodes_.size() + 1, 0);
+  frozen.dsts_.reserve(connections_.size());
+  frozen.weights_.reserve(connections_.size());
+  for (const auto& conn : connections_) {
+    ++frozen.offsets_[rank[std::get<0>(conn)->id] + 1];
+    frozen.dsts_.push_back(rank[std::get<1>(conn)->id]);
+    frozen.weights_.push_back(std::get<2>(conn));
+  }
+  std::partial_sum(frozen.offsets_.begin(), frozen.offsets_.end(), frozen.offsets_.begin());
+
+  // same for in-edges, the reversed records in incoming_ are grouped by dst
+  frozen.in_offsets_.assign(nodes_.size() + 1, 0);
+  frozen.srcs_.reserve(incoming_.size());
+  frozen.in_weights_.reserve(incoming_.size());
+  for (const auto& conn : incoming_) {
+    ++frozen.in_offsets_[rank[std::get<0>(conn)->id] + 1];
+    frozen.srcs_.push_back(rank[std::get<1>(conn)->id]);
+    frozen.in_weights_.push_back(std::get<2>(conn));
+  }
+  std::partial_sum(frozen.in_offsets_.begin(), frozen.in_offsets_.end(),
+                   frozen.in_offsets_.begin());
+  return frozen;
+}
+
+template <typename N, typename E>
+std::shared_ptr<const typename gdwg::Graph<N, E>::snapshot> gdwg::Graph<N, E>::Frozen() const {
+  // concurrent readers may both build the snapshot, either copy is correct
+  auto frozen = std::atomic_load(&frozen_);
+  if (!frozen) {
+    frozen = std::make_shared<const snapshot>(Freeze());
+    std::atomic_store(&frozen_, frozen);
+  }
+  return frozen;
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::node_id gdwg::Graph<N, E>::snapshot::Id(const N& val) const {
+  // nodes are sorted, binary search for the rank
+  auto it = std::lower_bound(nodes_.begin(), nodes_.end(), val, compare{});
+  if (it == nodes_.end() || val < (*it)->value) {
+    throw std::out_of_range("Cannot call Graph::snapshot::Id on a node that doesn't exist");
+  }
+  return static_cast<node_id>(it - nodes_.begin());
+}
+
+template <typename N, typename E>
+bool gdwg::Graph<N, E>::snapshot::IsNode(const N& val) const {
+  return std::binary_search(nodes_.begin(), nodes_.end(), val, compare{});
+}
+
+template <typename N, typename E>
+gdwg::Graph<N, E>::snapshot::const_iterator::const_iterator(const snapshot* frozen,
+                                                             std::size_t edge)
+  : frozen_{frozen}, src_{0}, edge_{edge} {
+  // the src owning the edge is the last one whose edges start at or before it, which skips nodes
+  // without out-edges, and past the last edge it is NodeCount()
+  const auto& offsets = frozen_->offsets_;
+  auto owner = std::upper_bound(offsets.begin(), offsets.end(), edge_) - offsets.begin() - 1;
+  src_ = static_cast<node_id>(std::min(static_cast<std::size_t>(owner), frozen_->NodeCount()));
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::snapshot::const_iterator& gdwg::Graph<N, E>::snapshot::
+    const_iterator::operator++() {
+  // move to the next edge, and to the next src once the current one runs out
+  ++edge_;
+  while (src_ < frozen_->NodeCount() && frozen_->offsets_[src_ + 1] <= edge_) {
+    ++src_;
+  }
+  return *this;
+}
+
+template <typename N, typename E>
+const typename gdwg::Graph<N, E>::snapshot::const_iterator gdwg::Graph<N, E>::snapshot::
+    const_iterator::operator++(int) {
+  // post-increment, make a copy and increment the copy
+  const_iterator it{*this};
+  ++(*this);
+  return it;
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::snapshot::const_iterator& gdwg::Graph<N, E>::snapshot::
+    const_iterator::operator--() {
+  // move to the previous edge, and back to the src owning it
+  --edge_;
+  while (frozen_->offsets_[src_] > edge_) {
+    --src_;
+  }
+  return *this;
+}
+
+template <typename N, typename E>
+const typename gdwg::Graph<N, E>::snapshot::const_iterator gdwg::Graph<N, E>::snapshot::
+    const_iterator::operator--(int) {
+  // post-decrement, make a copy and decrement the copy
+  const_iterator it{*this};
+  --(*this);
+  return it;
+}
+
+template <typename N, typename E>
+const typename gdwg::Graph<N, E>::snapshot::const_iterator::reference
+    gdwg::Graph<N, E>::snapshot::const_iterator::operator*() const {
+  // return const references
+  return {frozen_->Node(src_), frozen_->Node(frozen_->dsts_[edge_]), frozen_->weights_[edge_]};
 }
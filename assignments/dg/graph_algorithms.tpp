@@ -0,0 +1,1778 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <string>
+
+#include "assignments/dg/indexed_heap.h"
+#include "assignments/dg/sorted_intersection.h"
+#include "assignments/dg/thread_pool.h"
+
+template <typename N, typename E>
+gdwg::Graph<N, E>::shortest_paths::shortest_paths(std::shared_ptr<const snapshot> frozen,
+                                                  node_id src)
+  : frozen_{std::move(frozen)}, src_{src}, distances_(frozen_->NodeCount()),
+    parents_(frozen_->NodeCount(), no_node) {}
+
+template <typename N, typename E>
+bool gdwg::Graph<N, E>::shortest_paths::IsReachable(const N& dst) const {
+  if (!frozen_->IsNode(dst)) {
+    throw std::out_of_range(
+        "Cannot call Graph::shortest_paths::IsReachable if dst doesn't exist in the graph");
+  }
+  return parents_[frozen_->Id(dst)] != no_node;
+}
+
+template <typename N, typename E>
+E gdwg::Graph<N, E>::shortest_paths::Distance(const N& dst) const {
+  if (!IsReachable(dst)) {
+    throw std::runtime_error("Cannot call Graph::shortest_paths::Distance if dst is unreachable");
+  }
+  return distances_[frozen_->Id(dst)];
+}
+
+template <typename N, typename E>
+std::vector<std::reference_wrapper<const N>> gdwg::Graph<N, E>::shortest_paths::Path(
+    const N& dst) const {
+  if (!frozen_->IsNode(dst)) {
+    throw std::out_of_range(
+        "Cannot call Graph::shortest_paths::Path if dst doesn't exist in the graph");
+  }
+  return PathTo(frozen_->Id(dst));
+}
+
+template <typename N, typename E>
+std::vector<std::reference_wrapper<const N>> gdwg::Graph<N, E>::shortest_paths::PathTo(
+    node_id dst) const {
+  return TreePath(*frozen_, parents_, src_, dst);
+}
+
+template <typename N, typename E>
+gdwg::Graph<N, E>::bfs_tree::bfs_tree(std::shared_ptr<const snapshot> frozen, node_id src)
+  : frozen_{std::move(frozen)}, src_{src}, depths_(frozen_->NodeCount(), no_node),
+    parents_(frozen_->NodeCount(), no_node) {}
+
+template <typename N, typename E>
+bool gdwg::Graph<N, E>::bfs_tree::IsReachable(const N& dst) const {
+  if (!frozen_->IsNode(dst)) {
+    throw std::out_of_range(
+        "Cannot call Graph::bfs_tree::IsReachable if dst doesn't exist in the graph");
+  }
+  return parents_[frozen_->Id(dst)] != no_node;
+}
+
+template <typename N, typename E>
+std::size_t gdwg::Graph<N, E>::bfs_tree::Depth(const N& dst) const {
+  if (!IsReachable(dst)) {
+    throw std::runtime_error("Cannot call Graph::bfs_tree::Depth if dst is unreachable");
+  }
+  return depths_[frozen_->Id(dst)];
+}
+
+template <typename N, typename E>
+std::vector<std::reference_wrapper<const N>> gdwg::Graph<N, E>::bfs_tree::Path(
+    const N& dst) const {
+  if (!frozen_->IsNode(dst)) {
+    throw std::out_of_range("Cannot call Graph::bfs_tree::Path if dst doesn't exist in the graph");
+  }
+  return TreePath(*frozen_, parents_, src_, frozen_->Id(dst));
+}
+
+template <typename N, typename E>
+std::vector<std::reference_wrapper<const N>>
+gdwg::Graph<N, E>::TreePath(const snapshot& graph, const std::vector<node_id>& parents,
+                            node_id src, node_id dst) {
+  std::vector<std::reference_wrapper<const N>> path;
+  if (parents[dst] == no_node) {
+    // unreachable
+    return path;
+  }
+
+  // follow the parents back to the src, then reverse
+  for (node_id id = dst; id != src; id = parents[id]) {
+    path.push_back(std::cref(graph.Node(id)));
+  }
+  path.push_back(std::cref(graph.Node(src)));
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::shortest_paths gdwg::Graph<N, E>::ShortestPaths(const N& src) const {
+  if (!IsNode(src)) {
+    // node not exist
+    throw std::out_of_range("Cannot call Graph::ShortestPaths if src doesn't exist in the graph");
+  }
+
+  auto frozen = Frozen();
+  node_id id = frozen->Id(src);
+  return Dijkstra(std::move(frozen), id, no_node);
+}
+
+template <typename N, typename E>
+std::vector<std::reference_wrapper<const N>> gdwg::Graph<N, E>::ShortestPath(const N& src,
+                                                                            const N& dst) const {
+  if (!IsNode(src) || !IsNode(dst)) {
+    // not both nodes exist
+    throw std::out_of_range(
+        "Cannot call Graph::ShortestPath if src or dst node don't exist in the graph");
+  }
+
+  auto frozen = Frozen();
+  node_id src_id = frozen->Id(src);
+  node_id dst_id = frozen->Id(dst);
+  // a hierarchy that left much of the graph in its core is slower to search than the snapshot
+  auto index = use_path_index_ ? PathIndex("ShortestPath") : nullptr;
+  std::vector<node_id> ids = index && index->CoreSize() * 8 <= index->NodeCount()
+                                 ? index->Path(src_id, dst_id)
+                                 : BidirectionalDijkstra(*frozen, src_id, dst_id);
+
+  // nodes are shared with the snapshot, so the references stay valid like the graph's own
+  std::vector<std::reference_wrapper<const N>> path;
+  path.reserve(ids.size());
+  for (node_id id : ids) {
+    path.push_back(std::cref(frozen->Node(id)));
+  }
+  return path;
+}
+
+template <typename N, typename E>
+template <typename Heuristic>
+std::vector<std::reference_wrapper<const N>>
+gdwg::Graph<N, E>::AStar(const N& src, const N& dst, Heuristic heuristic) const {
+  static_assert(std::is_arithmetic<E>::value, "Graph::AStar needs arithmetic weights");
+  if (!IsNode(src) || !IsNode(dst)) {
+    // not both nodes exist
+    throw std::out_of_range("Cannot call Graph::AStar if src or dst node don't exist in the graph");
+  }
+
+  auto frozen = Frozen();
+  const snapshot& graph = *frozen;
+  const auto& offsets = graph.Offsets();
+  const auto& dsts = graph.Dsts();
+  const auto& weights = graph.Weights();
+  std::size_t count = graph.NodeCount();
+  node_id src_id = graph.Id(src);
+  node_id dst_id = graph.Id(dst);
+
+  // one scratch per thread, only ever grown, the nodes a search reaches are reset at its end
+  // estimates hold the heuristic of reached nodes, so it is called once per node
+  struct search {
+    IndexedHeap<E> open;
+    std::vector<std::uint64_t> closed;
+    std::vector<E> distances;
+    std::vector<E> estimates;
+    std::vector<node_id> parents;
+    std::vector<node_id> touched;
+  };
+  thread_local search state;
+  if (state.parents.size() < count) {
+    state.open.Reserve(count);
+    state.closed.resize((count + 63) / 64, 0);
+    state.distances.resize(count);
+    state.estimates.resize(count);
+    state.parents.resize(count, no_node);
+    state.touched.reserve(count);
+  }
+  auto is_closed = [](node_id id) { return (state.closed[id / 64] >> (id % 64)) & 1; };
+  auto reset = [] {
+    for (node_id id : state.touched) {
+      state.closed[id / 64] = 0;
+      state.parents[id] = no_node;
+    }
+    state.touched.clear();
+    state.open.Clear();
+  };
+
+  state.distances[src_id] = E{};
+  state.estimates[src_id] = heuristic(graph.Node(src_id));
+  state.parents[src_id] = src_id;
+  state.touched.push_back(src_id);
+  state.open.Push(src_id, state.estimates[src_id]);
+  bool found = false;
+  try {
+    while (!state.open.Empty()) {
+      node_id from = state.open.TopId();
+      state.open.Pop();
+      if (from == dst_id) {
+        found = true;
+        break;
+      }
+      state.closed[from / 64] |= std::uint64_t{1} << (from % 64);
+      for (std::size_t edge = offsets[from]; edge < offsets[from + 1]; ++edge) {
+        if (weights[edge] < E{}) {
+          throw std::runtime_error("Cannot call Graph::AStar on negative weights");
+        }
+        node_id to = dsts[edge];
+        if (is_closed(to)) {
+          continue;
+        }
+        E candidate = state.distances[from] + weights[edge];
+        if (state.parents[to] == no_node) {
+          state.estimates[to] = heuristic(graph.Node(to));
+          state.touched.push_back(to);
+        } else if (!(candidate < state.distances[to])) {
+          continue;
+        }
+        state.distances[to] = candidate;
+        state.parents[to] = from;
+        state.open.Push(to, candidate + state.estimates[to]);
+      }
+    }
+  } catch (...) {
+    reset();
+    throw;
+  }
+
+  // nodes are shared with the snapshot, so the references stay valid like the graph's own
+  std::vector<std::reference_wrapper<const N>> path;
+  if (found) {
+    for (node_id id = dst_id; id != src_id; id = state.parents[id]) {
+      path.push_back(std::cref(graph.Node(id)));
+    }
+    path.push_back(std::cref(graph.Node(src_id)));
+    std::reverse(path.begin(), path.end());
+  }
+  reset();
+  return path;
+}
+
+template <typename N, typename E>
+void gdwg::Graph<N, E>::BuildPathIndex() {
+  use_path_index_ = true;
+  PathIndex("BuildPathIndex");
+}
+
+template <typename N, typename E>
+std::shared_ptr<const gdwg::ContractionHierarchy<E>>
+gdwg::Graph<N, E>::PathIndex(const char* caller) const {
+  // concurrent readers may both build the index, either copy is correct
+  auto index = std::atomic_load(&path_index_);
+  if (!index) {
+    auto frozen = Frozen();
+    try {
+      index = std::make_shared<const ContractionHierarchy<E>>(frozen->Offsets(), frozen->Dsts(),
+                                                              frozen->Weights());
+    } catch (const std::runtime_error&) {
+      throw std::runtime_error(std::string{"Cannot call Graph::"} + caller +
+                               " on negative weights");
+    }
+    std::atomic_store(&path_index_, index);
+  }
+  return index;
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::shortest_paths
+gdwg::Graph<N, E>::Dijkstra(std::shared_ptr<const snapshot> frozen, node_id src, node_id dst) {
+  static_assert(std::is_arithmetic<E>::value, "Graph::ShortestPaths needs arithmetic weights");
+
+  shortest_paths paths{std::move(frozen), src};
+  const snapshot& graph = *paths.frozen_;
+  const auto& offsets = graph.Offsets();
+  const auto& dsts = graph.Dsts();
+  const auto& weights = graph.Weights();
+
+  // a node is settled once popped, its distance can no longer decrease
+  IndexedHeap<E> heap{graph.NodeCount()};
+  paths.distances_[src] = E{};
+  paths.parents_[src] = src;
+  heap.Push(src, E{});
+  while (!heap.Empty()) {
+    node_id from = heap.TopId();
+    E distance = heap.TopKey();
+    heap.Pop();
+    if (from == dst) {
+      break;
+    }
+
+    // out-edges of a node are contiguous in the snapshot
+    for (std::size_t edge = offsets[from]; edge < offsets[from + 1]; ++edge) {
+      if (weights[edge] < E{}) {
+        throw std::runtime_error("Cannot call Graph::ShortestPaths on negative weights");
+      }
+      node_id to = dsts[edge];
+      E candidate = distance + weights[edge];
+      if (paths.parents_[to] == no_node || candidate < paths.distances_[to]) {
+        // the src is settled first with distance zero, so it is never relaxed again
+        paths.distances_[to] = candidate;
+        paths.parents_[to] = from;
+        heap.Push(to, candidate);
+      }
+    }
+  }
+  return paths;
+}
+
+template <typename N, typename E>
+std::vector<typename gdwg::Graph<N, E>::node_id>
+gdwg::Graph<N, E>::BidirectionalDijkstra(const snapshot& graph, node_id src, node_id dst) {
+  static_assert(std::is_arithmetic<E>::value, "Graph::ShortestPath needs arithmetic weights");
+
+  // one search per direction, the backward one walks the in-edges of the snapshot
+  struct search {
+    const std::vector<std::size_t>& offsets;
+    const std::vector<node_id>& ends;
+    const std::vector<E>& weights;
+    std::vector<E> distances;
+    std::vector<node_id> parents;
+    IndexedHeap<E> heap;
+  };
+  std::size_t count = graph.NodeCount();
+  search forward{graph.Offsets(), graph.Dsts(), graph.Weights(),
+                 std::vector<E>(count), std::vector<node_id>(count, no_node),
+                 IndexedHeap<E>{count}};
+  search backward{graph.InOffsets(), graph.Srcs(), graph.InWeights(),
+                  std::vector<E>(count), std::vector<node_id>(count, no_node),
+                  IndexedHeap<E>{count}};
+  forward.distances[src] = E{};
+  forward.parents[src] = src;
+  forward.heap.Push(src, E{});
+  backward.distances[dst] = E{};
+  backward.parents[dst] = dst;
+  backward.heap.Push(dst, E{});
+
+  // best is the length of the shortest src -> meet -> dst path seen so far, no shorter path
+  // exists once the two smallest keys add up to it
+  E best{};
+  node_id meet = src == dst ? src : no_node;
+  while (!forward.heap.Empty() && !backward.heap.Empty()) {
+    if (meet != no_node && !(forward.heap.TopKey() + backward.heap.TopKey() < best)) {
+      break;
+    }
+    bool forward_turn = !(backward.heap.TopKey() < forward.heap.TopKey());
+    search& side = forward_turn ? forward : backward;
+    const search& other = forward_turn ? backward : forward;
+
+    node_id from = side.heap.TopId();
+    E distance = side.heap.TopKey();
+    side.heap.Pop();
+    for (std::size_t edge = side.offsets[from]; edge < side.offsets[from + 1]; ++edge) {
+      if (side.weights[edge] < E{}) {
+        throw std::runtime_error("Cannot call Graph::ShortestPath on negative weights");
+      }
+      node_id to = side.ends[edge];
+      E candidate = distance + side.weights[edge];
+      if (side.parents[to] == no_node || candidate < side.distances[to]) {
+        side.distances[to] = candidate;
+        side.parents[to] = from;
+        side.heap.Push(to, candidate);
+      }
+      if (other.parents[to] != no_node) {
+        E through = side.distances[to] + other.distances[to];
+        if (meet == no_node || through < best) {
+          best = through;
+          meet = to;
+        }
+      }
+    }
+  }
+
+  std::vector<node_id> path;
+  if (meet == no_node) {
+    // unreachable
+    return path;
+  }
+  for (node_id id = meet; id != src; id = forward.parents[id]) {
+    path.push_back(id);
+  }
+  path.push_back(src);
+  std::reverse(path.begin(), path.end());
+  for (node_id id = meet; id != dst; id = backward.parents[id]) {
+    path.push_back(backward.parents[id]);
+  }
+  return path;
+}
+
+template <typename N, typename E>
+gdwg::Graph<N, E>::distance_table::distance_table(std::shared_ptr<const snapshot> frozen)
+  : frozen_{std::move(frozen)},
+    distances_(frozen_->NodeCount() * frozen_->NodeCount(), Unreachable()) {}
+
+template <typename N, typename E>
+bool gdwg::Graph<N, E>::distance_table::IsReachable(const N& src, const N& dst) const {
+  if (!frozen_->IsNode(src) || !frozen_->IsNode(dst)) {
+    throw std::out_of_range("Cannot call Graph::distance_table::IsReachable if src or dst node "
+                            "don't exist in the graph");
+  }
+  return distances_[frozen_->Id(src) * frozen_->NodeCount() + frozen_->Id(dst)] != Unreachable();
+}
+
+template <typename N, typename E>
+E gdwg::Graph<N, E>::distance_table::Distance(const N& src, const N& dst) const {
+  if (!IsReachable(src, dst)) {
+    throw std::runtime_error("Cannot call Graph::distance_table::Distance if dst is unreachable");
+  }
+  return distances_[frozen_->Id(src) * frozen_->NodeCount() + frozen_->Id(dst)];
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::distance_table
+gdwg::Graph<N, E>::AllPairsShortestPaths(std::size_t threads) const {
+  static_assert(std::is_arithmetic<E>::value,
+                "Graph::AllPairsShortestPaths needs arithmetic weights");
+
+  distance_table table{Frozen()};
+  const snapshot& graph = *table.frozen_;
+  const auto& offsets = graph.Offsets();
+  const auto& dsts = graph.Dsts();
+  const auto& weights = graph.Weights();
+  std::size_t count = graph.NodeCount();
+  auto& distances = table.distances_;
+  // sums with an unreachable end stay above this, even after adding negative distances
+  const E reachable = distance_table::Unreachable() / 2;
+
+  // parallel edges are sorted by weight, so the first is the lightest
+  for (std::size_t from = 0; from < count; ++from) {
+    distances[from * count + from] = E{};
+    for (std::size_t edge = offsets[from]; edge < offsets[from + 1]; ++edge) {
+      E& distance = distances[from * count + dsts[edge]];
+      distance = std::min(distance, weights[edge]);
+    }
+  }
+
+  // relax the tile at rows of tile i and columns of tile j through the nodes of tile k
+  // with k outermost, the tile can be one it reads from, so the row of the via node is copied
+  // out first, then the inner loop runs along a contiguous row without branches or aliasing,
+  // and compilers vectorize it, with a fixed length on full tiles
+  constexpr std::size_t tile = 64;
+  std::size_t tiles = (count + tile - 1) / tile;
+  auto relax = [&distances, count, reachable](std::size_t i, std::size_t j, std::size_t k) {
+    std::size_t row_end = std::min((i + 1) * tile, count);
+    std::size_t column_begin = j * tile;
+    std::size_t width = std::min((j + 1) * tile, count) - column_begin;
+    std::size_t via_end = std::min((k + 1) * tile, count);
+    E via_row[tile];
+    for (std::size_t via = k * tile; via < via_end; ++via) {
+      std::copy_n(&distances[via * count + column_begin], width, via_row);
+      for (std::size_t row = i * tile; row < row_end; ++row) {
+        E first = distances[row * count + via];
+        if (!(first < reachable)) {
+          continue;
+        }
+        E* from_row = &distances[row * count + column_begin];
+        if (width == tile) {
+          for (std::size_t column = 0; column < tile; ++column) {
+            E candidate = first + via_row[column];
+            from_row[column] = candidate < from_row[column] ? candidate : from_row[column];
+          }
+        } else {
+          for (std::size_t column = 0; column < width; ++column) {
+            E candidate = first + via_row[column];
+            from_row[column] = candidate < from_row[column] ? candidate : from_row[column];
+          }
+        }
+      }
+    }
+  };
+
+  // each round finishes the tile on the diagonal, then the tiles in its row and column, which
+  // only read themselves and the diagonal tile, then every other tile, which reads those
+  ThreadPool& pool = ThreadPool::Shared();
+  for (std::size_t k = 0; k < tiles; ++k) {
+    relax(k, k, k);
+    auto cross = [&](std::size_t begin, std::size_t end, std::size_t) {
+      for (std::size_t other = begin; other < end; ++other) {
+        if (other != k) {
+          relax(k, other, k);
+          relax(other, k, k);
+        }
+      }
+    };
+    pool.ParallelFor(tiles, 1, cross, threads);
+    auto rest = [&](std::size_t begin, std::size_t end, std::size_t) {
+      for (std::size_t index = begin; index < end; ++index) {
+        std::size_t i = index / tiles;
+        std::size_t j = index % tiles;
+        if (i != k && j != k) {
+          relax(i, j, k);
+        }
+      }
+    };
+    pool.ParallelFor(tiles * tiles, 1, rest, threads);
+
+    // stop before a negative cycle drives distances down any further
+    for (std::size_t node = 0; node < count; ++node) {
+      if (distances[node * count + node] < E{}) {
+        throw std::runtime_error(
+            "Cannot call Graph::AllPairsShortestPaths on a graph with a negative cycle");
+      }
+    }
+  }
+
+  for (auto& distance : distances) {
+    if (!(distance < reachable)) {
+      distance = distance_table::Unreachable();
+    }
+  }
+  return table;
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::bfs_tree
+gdwg::Graph<N, E>::BreadthFirstSearch(const N& src, std::size_t threads) const {
+  if (!IsNode(src)) {
+    // node not exist
+    throw std::out_of_range(
+        "Cannot call Graph::BreadthFirstSearch if src doesn't exist in the graph");
+  }
+
+  auto frozen = Frozen();
+  node_id id = frozen->Id(src);
+  bfs_tree tree{std::move(frozen), id};
+  const snapshot& graph = *tree.frozen_;
+  const auto& offsets = graph.Offsets();
+  const auto& dsts = graph.Dsts();
+  const auto& in_offsets = graph.InOffsets();
+  const auto& srcs = graph.Srcs();
+  std::size_t count = graph.NodeCount();
+
+  // Beamer's thresholds, go bottom-up once the frontier has more than 1 / alpha of the edges
+  // left to check, and back top-down once it has less than 1 / beta of the nodes
+  constexpr std::size_t alpha = 14;
+  constexpr std::size_t beta = 24;
+  constexpr std::size_t grain = 256;
+
+  ThreadPool& pool = ThreadPool::Shared();
+  // a node is reached once it has a parent, top-down steps claim it with compare and swap
+  // its depth is written by the one thread that reached it
+  std::vector<std::atomic<node_id>> parents(count);
+  for (auto& parent : parents) {
+    parent.store(no_node, std::memory_order_relaxed);
+  }
+  // the frontier is always a list, and also a flag per node during bottom-up steps
+  // every thread appends the nodes it reaches to its own buffer
+  std::vector<node_id> frontier{id};
+  std::vector<unsigned char> in_frontier(count, 0);
+  std::vector<std::vector<node_id>> next(pool.ThreadCount());
+  parents[id].store(id, std::memory_order_relaxed);
+  tree.depths_[id] = 0;
+
+  std::size_t unchecked_edges = dsts.size();
+  std::size_t frontier_edges = offsets[id + 1] - offsets[id];
+  bool bottom_up = false;
+  for (node_id depth = 1; !frontier.empty(); ++depth) {
+    if (!bottom_up) {
+      bottom_up = frontier_edges > unchecked_edges / alpha;
+    } else {
+      bottom_up = frontier.size() >= count / beta;
+    }
+    unchecked_edges -= frontier_edges;
+
+    if (bottom_up) {
+      for (node_id node : frontier) {
+        in_frontier[node] = 1;
+      }
+      // every unreached node is only looked at by one thread, so no claim is needed
+      auto find_parents = [&](std::size_t begin, std::size_t end, std::size_t thread) {
+        for (std::size_t node = begin; node < end; ++node) {
+          if (parents[node].load(std::memory_order_relaxed) != no_node) {
+            continue;
+          }
+          // any parent in the frontier will do, so stop at the first
+          for (std::size_t edge = in_offsets[node]; edge < in_offsets[node + 1]; ++edge) {
+            if (in_frontier[srcs[edge]]) {
+              parents[node].store(srcs[edge], std::memory_order_relaxed);
+              tree.depths_[node] = depth;
+              next[thread].push_back(static_cast<node_id>(node));
+              break;
+            }
+          }
+        }
+      };
+      pool.ParallelFor(count, grain * 16, find_parents, threads);
+      for (node_id node : frontier) {
+        in_frontier[node] = 0;
+      }
+    } else {
+      auto claim_children = [&](std::size_t begin, std::size_t end, std::size_t thread) {
+        for (std::size_t i = begin; i < end; ++i) {
+          node_id from = frontier[i];
+          for (std::size_t edge = offsets[from]; edge < offsets[from + 1]; ++edge) {
+            node_id to = dsts[edge];
+            node_id unclaimed = no_node;
+            if (parents[to].load(std::memory_order_relaxed) == no_node &&
+                parents[to].compare_exchange_strong(unclaimed, from, std::memory_order_relaxed)) {
+              tree.depths_[to] = depth;
+              next[thread].push_back(to);
+            }
+          }
+        }
+      };
+      pool.ParallelFor(frontier.size(), grain, claim_children, threads);
+    }
+
+    // gather the next frontier from the thread buffers
+    frontier.clear();
+    frontier_edges = 0;
+    for (auto& reached : next) {
+      for (node_id node : reached) {
+        frontier_edges += offsets[node + 1] - offsets[node];
+      }
+      frontier.insert(frontier.end(), reached.begin(), reached.end());
+      reached.clear();
+    }
+  }
+
+  for (std::size_t node = 0; node < count; ++node) {
+    tree.parents_[node] = parents[node].load(std::memory_order_relaxed);
+  }
+  return tree;
+}
+
+template <typename N, typename E>
+template <typename T>
+std::vector<T> gdwg::Graph<N, E>::snapshot::Multiply(const std::vector<T>& x,
+                                                     std::size_t threads) const {
+  if (x.size() != NodeCount()) {
+    throw std::runtime_error(
+        "Cannot call Graph::snapshot::Multiply with a vector not of one value per node");
+  }
+
+  // pulled along the in-edges, so every y[dst] is written by one thread without atomics
+  std::vector<T> y(NodeCount(), T{});
+  auto rows = [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t dst = begin; dst < end; ++dst) {
+      T sum{};
+      for (std::size_t edge = in_offsets_[dst]; edge < in_offsets_[dst + 1]; ++edge) {
+        sum += static_cast<T>(in_weights_[edge]) * x[srcs_[edge]];
+      }
+      y[dst] = sum;
+    }
+  };
+  ThreadPool::Shared().ParallelFor(NodeCount(), 4096, rows, threads);
+  return y;
+}
+
+template <typename N, typename E>
+gdwg::Graph<N, E>::page_ranks::page_ranks(std::shared_ptr<const snapshot> frozen)
+  : frozen_{std::move(frozen)}, ranks_(frozen_->NodeCount()) {}
+
+template <typename N, typename E>
+double gdwg::Graph<N, E>::page_ranks::Rank(const N& node) const {
+  if (!frozen_->IsNode(node)) {
+    throw std::out_of_range(
+        "Cannot call Graph::page_ranks::Rank if node doesn't exist in the graph");
+  }
+  return ranks_[frozen_->Id(node)];
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::page_ranks gdwg::Graph<N, E>::PageRank(double damping,
+                                                                   double tolerance,
+                                                                   std::size_t max_iterations,
+                                                                   std::size_t threads) const {
+  static_assert(std::is_arithmetic<E>::value, "Graph::PageRank needs arithmetic weights");
+  if (!(damping >= 0 && damping <= 1)) {
+    throw std::runtime_error("Cannot call Graph::PageRank with a damping outside [0, 1]");
+  }
+
+  page_ranks result{Frozen()};
+  const snapshot& graph = *result.frozen_;
+  const auto& offsets = graph.Offsets();
+  const auto& weights = graph.Weights();
+  const auto& in_offsets = graph.InOffsets();
+  const auto& srcs = graph.Srcs();
+  const auto& in_weights = graph.InWeights();
+  std::size_t count = graph.NodeCount();
+  if (count == 0) {
+    result.converged_ = true;
+    return result;
+  }
+
+  constexpr std::size_t grain = 4096;
+  ThreadPool& pool = ThreadPool::Shared();
+  // sums are reduced from one partial per thread
+  std::vector<double> partials(pool.ThreadCount());
+  auto reduce = [&partials] {
+    double sum = std::accumulate(partials.begin(), partials.end(), 0.0);
+    std::fill(partials.begin(), partials.end(), 0.0);
+    return sum;
+  };
+
+  std::vector<double> out_weights(count);
+  auto sum_out_weights = [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t node = begin; node < end; ++node) {
+      double sum = 0;
+      for (std::size_t edge = offsets[node]; edge < offsets[node + 1]; ++edge) {
+        if (weights[edge] < E{}) {
+          throw std::runtime_error("Cannot call Graph::PageRank on negative weights");
+        }
+        sum += static_cast<double>(weights[edge]);
+      }
+      out_weights[node] = sum;
+    }
+  };
+  pool.ParallelFor(count, grain, sum_out_weights, threads);
+
+  // rank passed along each unit of weight, and rank of nodes with nothing to pass it along
+  std::vector<double>& ranks = result.ranks_;
+  std::vector<double> shares(count);
+  std::vector<double> next(count);
+  std::fill(ranks.begin(), ranks.end(), 1.0 / count);
+  auto share = [&](std::size_t begin, std::size_t end, std::size_t thread) {
+    for (std::size_t node = begin; node < end; ++node) {
+      if (out_weights[node] > 0) {
+        shares[node] = ranks[node] / out_weights[node];
+      } else {
+        shares[node] = 0;
+        partials[thread] += ranks[node];
+      }
+    }
+  };
+  double base = 0;
+  auto pull = [&](std::size_t begin, std::size_t end, std::size_t thread) {
+    for (std::size_t node = begin; node < end; ++node) {
+      double sum = 0;
+      for (std::size_t edge = in_offsets[node]; edge < in_offsets[node + 1]; ++edge) {
+        sum += static_cast<double>(in_weights[edge]) * shares[srcs[edge]];
+      }
+      next[node] = base + damping * sum;
+      partials[thread] += std::abs(next[node] - ranks[node]);
+    }
+  };
+  while (result.iterations_ < max_iterations && !result.converged_) {
+    pool.ParallelFor(count, grain, share, threads);
+    base = ((1 - damping) + damping * reduce()) / count;
+    pool.ParallelFor(count, grain, pull, threads);
+    ranks.swap(next);
+    ++result.iterations_;
+    result.converged_ = reduce() < tolerance;
+  }
+  return result;
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::adjacency gdwg::Graph<N, E>::Undirected(const snapshot& graph,
+                                                                    std::size_t threads) {
+  const auto& offsets = graph.Offsets();
+  const auto& dsts = graph.Dsts();
+  const auto& in_offsets = graph.InOffsets();
+  const auto& srcs = graph.Srcs();
+  std::size_t count = graph.NodeCount();
+
+  // the out-edges and in-edges of a node are both sorted, so one merge gives its neighbours
+  // it runs twice, to count then to fill, so nothing is allocated per node
+  adjacency result;
+  result.offsets.assign(count + 1, 0);
+  auto merge = [&](node_id node, node_id* out) {
+    std::size_t size = 0;
+    std::size_t edge = offsets[node];
+    std::size_t in_edge = in_offsets[node];
+    node_id last = no_node;
+    while (edge < offsets[node + 1] || in_edge < in_offsets[node + 1]) {
+      node_id next;
+      if (in_edge == in_offsets[node + 1] ||
+          (edge < offsets[node + 1] && dsts[edge] < srcs[in_edge])) {
+        next = dsts[edge++];
+      } else {
+        next = srcs[in_edge++];
+      }
+      if (next != last && next != node) {
+        if (out != nullptr) {
+          out[size] = next;
+        }
+        ++size;
+      }
+      last = next;
+    }
+    return size;
+  };
+  constexpr std::size_t grain = 4096;
+  ThreadPool& pool = ThreadPool::Shared();
+  auto count_range = [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t node = begin; node < end; ++node) {
+      result.offsets[node + 1] = merge(static_cast<node_id>(node), nullptr);
+    }
+  };
+  pool.ParallelFor(count, grain, count_range, threads);
+  std::partial_sum(result.offsets.begin(), result.offsets.end(), result.offsets.begin());
+  result.nodes.resize(result.offsets.back());
+  auto fill_range = [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t node = begin; node < end; ++node) {
+      merge(static_cast<node_id>(node), result.nodes.data() + result.offsets[node]);
+    }
+  };
+  pool.ParallelFor(count, grain, fill_range, threads);
+  return result;
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::adjacency gdwg::Graph<N, E>::HigherDegree(const adjacency& graph,
+                                                                      std::size_t threads) {
+  std::size_t count = graph.offsets.size() - 1;
+  auto higher = [&graph](node_id node, node_id neighbour) {
+    std::size_t degree = graph.offsets[node + 1] - graph.offsets[node];
+    std::size_t neighbour_degree = graph.offsets[neighbour + 1] - graph.offsets[neighbour];
+    return degree < neighbour_degree || (degree == neighbour_degree && node < neighbour);
+  };
+
+  adjacency result;
+  result.offsets.assign(count + 1, 0);
+  constexpr std::size_t grain = 4096;
+  ThreadPool& pool = ThreadPool::Shared();
+  auto count_range = [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t node = begin; node < end; ++node) {
+      for (std::size_t i = graph.offsets[node]; i < graph.offsets[node + 1]; ++i) {
+        result.offsets[node + 1] += higher(static_cast<node_id>(node), graph.nodes[i]);
+      }
+    }
+  };
+  pool.ParallelFor(count, grain, count_range, threads);
+  std::partial_sum(result.offsets.begin(), result.offsets.end(), result.offsets.begin());
+  result.nodes.resize(result.offsets.back());
+  auto fill_range = [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t node = begin; node < end; ++node) {
+      std::size_t next = result.offsets[node];
+      for (std::size_t i = graph.offsets[node]; i < graph.offsets[node + 1]; ++i) {
+        if (higher(static_cast<node_id>(node), graph.nodes[i])) {
+          result.nodes[next++] = graph.nodes[i];
+        }
+      }
+    }
+  };
+  pool.ParallelFor(count, grain, fill_range, threads);
+  return result;
+}
+
+template <typename N, typename E>
+std::size_t gdwg::Graph<N, E>::CountTriangles(std::size_t threads) const {
+  auto frozen = Frozen();
+  adjacency higher = HigherDegree(Undirected(*frozen, threads), threads);
+  const auto& offsets = higher.offsets;
+  const auto* nodes = higher.nodes.data();
+
+  // a triangle is counted from its node of least degree a, through its middle node b, as the
+  // common higher neighbour c of both
+  ThreadPool& pool = ThreadPool::Shared();
+  std::vector<std::size_t> partials(pool.ThreadCount());
+  auto count_range = [&](std::size_t begin, std::size_t end, std::size_t thread) {
+    for (std::size_t a = begin; a < end; ++a) {
+      for (std::size_t i = offsets[a]; i < offsets[a + 1]; ++i) {
+        node_id b = nodes[i];
+        partials[thread] += IntersectionSize(nodes + offsets[a], nodes + offsets[a + 1],
+                                             nodes + offsets[b], nodes + offsets[b + 1]);
+      }
+    }
+  };
+  pool.ParallelFor(frozen->NodeCount(), 256, count_range, threads);
+  return std::accumulate(partials.begin(), partials.end(), std::size_t{0});
+}
+
+template <typename N, typename E>
+gdwg::Graph<N, E>::clustering::clustering(std::shared_ptr<const snapshot> frozen)
+  : frozen_{std::move(frozen)}, triangles_(frozen_->NodeCount()),
+    coefficients_(frozen_->NodeCount()) {}
+
+template <typename N, typename E>
+std::size_t gdwg::Graph<N, E>::clustering::Triangles(const N& node) const {
+  if (!frozen_->IsNode(node)) {
+    throw std::out_of_range(
+        "Cannot call Graph::clustering::Triangles if node doesn't exist in the graph");
+  }
+  return triangles_[frozen_->Id(node)];
+}
+
+template <typename N, typename E>
+double gdwg::Graph<N, E>::clustering::Coefficient(const N& node) const {
+  if (!frozen_->IsNode(node)) {
+    throw std::out_of_range(
+        "Cannot call Graph::clustering::Coefficient if node doesn't exist in the graph");
+  }
+  return coefficients_[frozen_->Id(node)];
+}
+
+template <typename N, typename E>
+double gdwg::Graph<N, E>::clustering::AverageCoefficient() const noexcept {
+  if (coefficients_.empty()) {
+    return 0;
+  }
+  return std::accumulate(coefficients_.begin(), coefficients_.end(), 0.0) / coefficients_.size();
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::clustering
+gdwg::Graph<N, E>::ClusteringCoefficients(std::size_t threads) const {
+  clustering result{Frozen()};
+  std::size_t count = result.frozen_->NodeCount();
+  adjacency neighbours = Undirected(*result.frozen_, threads);
+  adjacency higher = HigherDegree(neighbours, threads);
+  const auto& offsets = higher.offsets;
+  const auto* nodes = higher.nodes.data();
+
+  // found like CountTriangles(), every triangle adds one to each of its three nodes
+  std::vector<std::atomic<std::size_t>> triangles(count);
+  for (auto& triangle : triangles) {
+    triangle.store(0, std::memory_order_relaxed);
+  }
+  ThreadPool& pool = ThreadPool::Shared();
+  auto count_range = [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t a = begin; a < end; ++a) {
+      for (std::size_t i = offsets[a]; i < offsets[a + 1]; ++i) {
+        node_id b = nodes[i];
+        ForEachCommon(nodes + offsets[a], nodes + offsets[a + 1], nodes + offsets[b],
+                      nodes + offsets[b + 1], [&](node_id c) {
+                        triangles[a].fetch_add(1, std::memory_order_relaxed);
+                        triangles[b].fetch_add(1, std::memory_order_relaxed);
+                        triangles[c].fetch_add(1, std::memory_order_relaxed);
+                      });
+      }
+    }
+  };
+  pool.ParallelFor(count, 256, count_range, threads);
+
+  for (std::size_t node = 0; node < count; ++node) {
+    std::size_t degree = neighbours.offsets[node + 1] - neighbours.offsets[node];
+    result.triangles_[node] = triangles[node].load(std::memory_order_relaxed);
+    result.coefficients_[node] =
+        degree < 2 ? 0.0 : 2.0 * result.triangles_[node] / (degree * (degree - 1));
+  }
+  return result;
+}
+
+template <typename N, typename E>
+std::vector<std::size_t> gdwg::Graph<N, E>::snapshot::OutDegrees() const {
+  std::vector<std::size_t> degrees(NodeCount());
+  std::adjacent_difference(offsets_.begin() + 1, offsets_.end(), degrees.begin());
+  return degrees;
+}
+
+template <typename N, typename E>
+std::vector<std::size_t> gdwg::Graph<N, E>::snapshot::InDegrees() const {
+  std::vector<std::size_t> degrees(NodeCount());
+  std::adjacent_difference(in_offsets_.begin() + 1, in_offsets_.end(), degrees.begin());
+  return degrees;
+}
+
+template <typename N, typename E>
+std::vector<std::size_t> gdwg::Graph<N, E>::snapshot::OutDegreeHistogram() const {
+  return Histogram(OutDegrees());
+}
+
+template <typename N, typename E>
+std::vector<std::size_t> gdwg::Graph<N, E>::snapshot::InDegreeHistogram() const {
+  return Histogram(InDegrees());
+}
+
+template <typename N, typename E>
+std::vector<std::size_t> gdwg::Graph<N, E>::Histogram(const std::vector<std::size_t>& degrees) {
+  std::vector<std::size_t> histogram;
+  for (std::size_t degree : degrees) {
+    if (degree >= histogram.size()) {
+      histogram.resize(degree + 1, 0);
+    }
+    ++histogram[degree];
+  }
+  return histogram;
+}
+
+template <typename N, typename E>
+gdwg::Graph<N, E>::cores::cores(std::shared_ptr<const snapshot> frozen)
+  : frozen_{std::move(frozen)}, core_numbers_(frozen_->NodeCount()) {}
+
+template <typename N, typename E>
+std::size_t gdwg::Graph<N, E>::cores::CoreNumber(const N& node) const {
+  if (!frozen_->IsNode(node)) {
+    throw std::out_of_range(
+        "Cannot call Graph::cores::CoreNumber if node doesn't exist in the graph");
+  }
+  return core_numbers_[frozen_->Id(node)];
+}
+
+template <typename N, typename E>
+std::vector<std::reference_wrapper<const N>> gdwg::Graph<N, E>::cores::Core(std::size_t k) const {
+  std::vector<std::reference_wrapper<const N>> nodes;
+  for (node_id id = 0; id < core_numbers_.size(); ++id) {
+    if (core_numbers_[id] >= k) {
+      nodes.push_back(std::cref(frozen_->Node(id)));
+    }
+  }
+  return nodes;
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::cores gdwg::Graph<N, E>::CoreDecomposition() const {
+  cores result{Frozen()};
+  adjacency neighbours = Undirected(*result.frozen_, 0);
+  std::size_t count = result.frozen_->NodeCount();
+
+  // Batagelj and Zaversnik, nodes sorted by current degree, with the first position of every
+  // degree in starts, a neighbour losing a degree is swapped to the front of its bucket, which
+  // then starts one later, so it is in the bucket below
+  std::vector<std::size_t>& degrees = result.core_numbers_;
+  for (std::size_t node = 0; node < count; ++node) {
+    degrees[node] = neighbours.offsets[node + 1] - neighbours.offsets[node];
+  }
+  std::vector<std::size_t> starts = Histogram(degrees);
+  std::size_t start = 0;
+  for (auto& bucket : starts) {
+    start += std::exchange(bucket, start);
+  }
+  std::vector<node_id> sorted(count);
+  std::vector<std::size_t> positions(count);
+  {
+    std::vector<std::size_t> next = starts;
+    for (node_id node = 0; node < count; ++node) {
+      positions[node] = next[degrees[node]]++;
+      sorted[positions[node]] = node;
+    }
+  }
+
+  // the degree of a node when it is peeled is its core number
+  for (std::size_t i = 0; i < count; ++i) {
+    node_id node = sorted[i];
+    for (std::size_t j = neighbours.offsets[node]; j < neighbours.offsets[node + 1]; ++j) {
+      node_id neighbour = neighbours.nodes[j];
+      if (degrees[neighbour] <= degrees[node]) {
+        continue;
+      }
+      std::size_t degree = degrees[neighbour];
+      node_id first = sorted[starts[degree]];
+      std::swap(sorted[positions[neighbour]], sorted[starts[degree]]);
+      std::swap(positions[neighbour], positions[first]);
+      ++starts[degree];
+      --degrees[neighbour];
+    }
+  }
+  result.degeneracy_ = count == 0 ? 0 : *std::max_element(degrees.begin(), degrees.end());
+  return result;
+}
+
+template <typename N, typename E>
+gdwg::Graph<N, E>::centrality::centrality(std::shared_ptr<const snapshot> frozen)
+  : frozen_{std::move(frozen)}, scores_(frozen_->NodeCount()) {}
+
+template <typename N, typename E>
+double gdwg::Graph<N, E>::centrality::Score(const N& node) const {
+  if (!frozen_->IsNode(node)) {
+    throw std::out_of_range(
+        "Cannot call Graph::centrality::Score if node doesn't exist in the graph");
+  }
+  return scores_[frozen_->Id(node)];
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::centrality
+gdwg::Graph<N, E>::Betweenness(bool weighted, std::size_t samples, std::size_t threads) const {
+  centrality result{Frozen()};
+  const snapshot& graph = *result.frozen_;
+  const auto& offsets = graph.Offsets();
+  const auto& dsts = graph.Dsts();
+  const auto& weights = graph.Weights();
+  const auto& in_offsets = graph.InOffsets();
+  const auto& srcs = graph.Srcs();
+  const auto& in_weights = graph.InWeights();
+  std::size_t count = graph.NodeCount();
+
+  std::vector<node_id> sources(count);
+  std::iota(sources.begin(), sources.end(), 0);
+  if (samples > 0 && samples < count) {
+    std::shuffle(sources.begin(), sources.end(), std::mt19937{6771});
+    sources.resize(samples);
+  }
+
+  // state of a search, reset through the reached nodes only, and scores of every thread
+  // sigmas count shortest paths, and are doubles since the counts overflow integers
+  struct search {
+    std::vector<double> scores;
+    std::vector<double> sigmas;
+    std::vector<double> deltas;
+    std::vector<node_id> depths;
+    std::vector<E> distances;
+    std::vector<node_id> order;
+    IndexedHeap<E> heap;
+  };
+  ThreadPool& pool = ThreadPool::Shared();
+  std::vector<search> searches(pool.ThreadCount());
+
+  // parallel edges are next to each other, the first is the lightest, self loops are skipped
+  auto skip_out = [&](std::size_t node, std::size_t edge) {
+    return dsts[edge] == node || (edge > offsets[node] && dsts[edge] == dsts[edge - 1]);
+  };
+  auto skip_in = [&](std::size_t node, std::size_t edge) {
+    return srcs[edge] == node || (edge > in_offsets[node] && srcs[edge] == srcs[edge - 1]);
+  };
+
+  // search from src, then pass dependencies back in reverse order of distance
+  // a node v is before w on a shortest path if is_before(v, edge, w), edge being v -> w
+  auto accumulate = [&](search& state, node_id src, auto is_before) {
+    for (auto it = state.order.rbegin(); it != state.order.rend(); ++it) {
+      node_id to = *it;
+      double share = (1 + state.deltas[to]) / state.sigmas[to];
+      for (std::size_t edge = in_offsets[to]; edge < in_offsets[to + 1]; ++edge) {
+        node_id from = srcs[edge];
+        if (!skip_in(to, edge) && is_before(from, edge, to)) {
+          state.deltas[from] += state.sigmas[from] * share;
+        }
+      }
+      if (to != src) {
+        state.scores[to] += state.deltas[to];
+      }
+    }
+    for (node_id node : state.order) {
+      state.sigmas[node] = 0;
+      state.deltas[node] = 0;
+      state.depths[node] = no_node;
+    }
+    state.order.clear();
+  };
+
+  auto breadth_first = [&](search& state, node_id src) {
+    state.sigmas[src] = 1;
+    state.depths[src] = 0;
+    state.order.push_back(src);
+    for (std::size_t i = 0; i < state.order.size(); ++i) {
+      node_id from = state.order[i];
+      for (std::size_t edge = offsets[from]; edge < offsets[from + 1]; ++edge) {
+        node_id to = dsts[edge];
+        if (skip_out(from, edge)) {
+          continue;
+        }
+        if (state.depths[to] == no_node) {
+          state.depths[to] = state.depths[from] + 1;
+          state.order.push_back(to);
+        }
+        if (state.depths[to] == state.depths[from] + 1) {
+          state.sigmas[to] += state.sigmas[from];
+        }
+      }
+    }
+    accumulate(state, src, [&state](node_id from, std::size_t, node_id to) {
+      return state.depths[from] != no_node && state.depths[from] + 1 == state.depths[to];
+    });
+  };
+
+  // depths are positions in order of settled nodes here, and unsettled for reached ones, so
+  // paths over zero weights only count in the order their ends are settled
+  auto dijkstra = [&](search& state, node_id src) {
+    if constexpr (std::is_arithmetic<E>::value) {
+      const auto unsettled = static_cast<node_id>(count);
+      state.sigmas[src] = 1;
+      state.depths[src] = unsettled;
+      state.distances[src] = E{};
+      state.heap.Push(src, E{});
+      while (!state.heap.Empty()) {
+        node_id from = state.heap.TopId();
+        state.heap.Pop();
+        state.depths[from] = static_cast<node_id>(state.order.size());
+        state.order.push_back(from);
+        for (std::size_t edge = offsets[from]; edge < offsets[from + 1]; ++edge) {
+          if (weights[edge] < E{}) {
+            throw std::runtime_error("Cannot call Graph::Betweenness on negative weights");
+          }
+          node_id to = dsts[edge];
+          if (skip_out(from, edge)) {
+            continue;
+          }
+          E candidate = state.distances[from] + weights[edge];
+          if (state.depths[to] == no_node || candidate < state.distances[to]) {
+            state.depths[to] = unsettled;
+            state.distances[to] = candidate;
+            state.sigmas[to] = state.sigmas[from];
+            state.heap.Push(to, candidate);
+          } else if (candidate == state.distances[to] && state.depths[to] == unsettled) {
+            state.sigmas[to] += state.sigmas[from];
+          }
+        }
+      }
+      accumulate(state, src, [&](node_id from, std::size_t edge, node_id to) {
+        return state.depths[from] < state.depths[to] &&
+               state.distances[from] + in_weights[edge] == state.distances[to];
+      });
+    } else {
+      (void)state;
+      (void)src;
+      (void)weights;
+      (void)in_weights;
+      throw std::runtime_error("Cannot call Graph::Betweenness weighted on non-arithmetic weights");
+    }
+  };
+
+  // one src per chunk, handed out from the pool's counter, so threads that finish early take
+  // the srcs left over instead of idling
+  auto run = [&](std::size_t begin, std::size_t end, std::size_t thread) {
+    search& state = searches[thread];
+    if (state.scores.empty()) {
+      state.scores.assign(count, 0);
+      state.sigmas.assign(count, 0);
+      state.deltas.assign(count, 0);
+      state.depths.assign(count, no_node);
+      if (weighted) {
+        state.distances.resize(count);
+        state.heap.Reserve(count);
+      }
+    }
+    for (std::size_t i = begin; i < end; ++i) {
+      if (weighted) {
+        dijkstra(state, sources[i]);
+      } else {
+        breadth_first(state, sources[i]);
+      }
+    }
+  };
+  pool.ParallelFor(sources.size(), 1, run, threads);
+
+  double scale = sources.empty() ? 0 : static_cast<double>(count) / sources.size();
+  for (const auto& state : searches) {
+    for (std::size_t node = 0; node < state.scores.size(); ++node) {
+      result.scores_[node] += state.scores[node] * scale;
+    }
+  }
+  return result;
+}
+
+template <typename N, typename E>
+gdwg::Graph<N, E>::flow::flow(std::shared_ptr<const snapshot> frozen)
+  : frozen_{std::move(frozen)}, source_side_(frozen_->NodeCount(), 0) {}
+
+template <typename N, typename E>
+bool gdwg::Graph<N, E>::flow::IsSourceSide(const N& node) const {
+  if (!frozen_->IsNode(node)) {
+    throw std::out_of_range(
+        "Cannot call Graph::flow::IsSourceSide if node doesn't exist in the graph");
+  }
+  return source_side_[frozen_->Id(node)] != 0;
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::flow gdwg::Graph<N, E>::MaxFlow(const N& source,
+                                                            const N& sink) const {
+  static_assert(std::is_arithmetic<E>::value, "Graph::MaxFlow needs arithmetic capacities");
+  if (!IsNode(source) || !IsNode(sink)) {
+    throw std::out_of_range(
+        "Cannot call Graph::MaxFlow if source or sink node don't exist in the graph");
+  }
+  flow result{Frozen()};
+  const snapshot& graph = *result.frozen_;
+  const auto& offsets = graph.Offsets();
+  const auto& dsts = graph.Dsts();
+  const auto& weights = graph.Weights();
+  std::size_t count = graph.NodeCount();
+  node_id src = graph.Id(source);
+  node_id dst = graph.Id(sink);
+  if (src == dst) {
+    throw std::runtime_error("Cannot call Graph::MaxFlow if source and sink are the same node");
+  }
+
+  // residual arcs in flat arrays, the arcs of node i at [heads[i], heads[i + 1]), each pair of
+  // nodes with edges gets one arc of their summed capacity, and a reverse arc of none
+  // parallel edges are next to each other in the snapshot
+  auto skip = [&](std::size_t from, std::size_t edge) {
+    return dsts[edge] == from || (edge > offsets[from] && dsts[edge] == dsts[edge - 1]);
+  };
+  std::vector<std::size_t> heads(count + 1, 0);
+  for (std::size_t from = 0; from < count; ++from) {
+    for (std::size_t edge = offsets[from]; edge < offsets[from + 1]; ++edge) {
+      if (weights[edge] < E{}) {
+        throw std::runtime_error("Cannot call Graph::MaxFlow on negative capacities");
+      }
+      if (!skip(from, edge)) {
+        ++heads[from + 1];
+        ++heads[dsts[edge] + 1];
+      }
+    }
+  }
+  std::partial_sum(heads.begin(), heads.end(), heads.begin());
+  std::vector<node_id> ends(heads.back());
+  std::vector<E> capacities(heads.back());
+  std::vector<std::size_t> reverses(heads.back());
+  std::vector<std::size_t> next(heads.begin(), heads.end() - 1);
+  for (std::size_t from = 0; from < count; ++from) {
+    for (std::size_t edge = offsets[from]; edge < offsets[from + 1]; ++edge) {
+      node_id to = dsts[edge];
+      if (to == from) {
+        continue;
+      }
+      if (skip(from, edge)) {
+        capacities[next[from] - 1] += weights[edge];
+        continue;
+      }
+      std::size_t forward = next[from]++;
+      std::size_t backward = next[to]++;
+      ends[forward] = to;
+      capacities[forward] = weights[edge];
+      reverses[forward] = backward;
+      ends[backward] = static_cast<node_id>(from);
+      capacities[backward] = E{};
+      reverses[backward] = forward;
+    }
+  }
+
+  // levels of nodes by residual arcs from src, no_node for nodes not reached
+  std::vector<node_id> levels(count);
+  std::vector<node_id> queue;
+  queue.reserve(count);
+  auto level = [&] {
+    std::fill(levels.begin(), levels.end(), no_node);
+    levels[src] = 0;
+    queue.assign(1, src);
+    for (std::size_t i = 0; i < queue.size(); ++i) {
+      node_id from = queue[i];
+      for (std::size_t arc = heads[from]; arc < heads[from + 1]; ++arc) {
+        if (E{} < capacities[arc] && levels[ends[arc]] == no_node) {
+          levels[ends[arc]] = levels[from] + 1;
+          queue.push_back(ends[arc]);
+        }
+      }
+    }
+    return levels[dst] != no_node;
+  };
+
+  // blocking flow of each level graph, by paths advanced arc by arc from the current arc of each
+  // node, dead ends are taken out of the level graph, and after each augment the path is kept up
+  // to its first saturated arc
+  std::vector<std::size_t> current(count);
+  std::vector<std::size_t> path;
+  while (level()) {
+    std::copy(heads.begin(), heads.end() - 1, current.begin());
+    path.clear();
+    node_id node = src;
+    while (true) {
+      if (node == dst) {
+        E bottleneck = capacities[path.front()];
+        for (std::size_t arc : path) {
+          bottleneck = std::min(bottleneck, capacities[arc]);
+        }
+        std::size_t saturated = path.size();
+        for (std::size_t i = 0; i < path.size(); ++i) {
+          capacities[path[i]] -= bottleneck;
+          capacities[reverses[path[i]]] += bottleneck;
+          if (saturated == path.size() && !(E{} < capacities[path[i]])) {
+            saturated = i;
+          }
+        }
+        result.value_ += bottleneck;
+        path.resize(saturated);
+        node = path.empty() ? src : ends[path.back()];
+        continue;
+      }
+      std::size_t& arc = current[node];
+      while (arc < heads[node + 1] &&
+             !(E{} < capacities[arc] && levels[ends[arc]] == levels[node] + 1)) {
+        ++arc;
+      }
+      if (arc < heads[node + 1]) {
+        path.push_back(arc);
+        node = ends[arc];
+      } else if (node == src) {
+        break;
+      } else {
+        levels[node] = no_node;
+        path.pop_back();
+        node = path.empty() ? src : ends[path.back()];
+      }
+    }
+  }
+
+  // the last level graph didn't reach dst, so the nodes it reached are the source side
+  for (std::size_t node = 0; node < count; ++node) {
+    result.source_side_[node] = levels[node] != no_node;
+  }
+  for (std::size_t from = 0; from < count; ++from) {
+    for (std::size_t edge = offsets[from]; edge < offsets[from + 1]; ++edge) {
+      if (result.source_side_[from] && !result.source_side_[dsts[edge]]) {
+        result.cut_edges_.push_back(
+            typename snapshot::const_iterator{&graph, static_cast<node_id>(from), edge});
+      }
+    }
+  }
+  return result;
+}
+
+template <typename N, typename E>
+std::vector<typename gdwg::Graph<N, E>::const_iterator>
+gdwg::Graph<N, E>::MinimumSpanningForest(std::size_t threads) const {
+  std::shared_ptr<const snapshot> frozen = Frozen();
+  const snapshot& graph = *frozen;
+  const auto& offsets = graph.Offsets();
+  const auto& dsts = graph.Dsts();
+  const auto& weights = graph.Weights();
+  std::size_t count = graph.NodeCount();
+
+  // every edge but self loops, and only the lightest of parallel edges, which comes first
+  // weights are copied in, so the sort doesn't jump around the snapshot
+  struct candidate {
+    E weight;
+    std::size_t edge;
+    node_id src;
+  };
+  std::vector<candidate> candidates;
+  candidates.reserve(graph.EdgeCount());
+  for (std::size_t from = 0; from < count; ++from) {
+    for (std::size_t edge = offsets[from]; edge < offsets[from + 1]; ++edge) {
+      if (dsts[edge] != from && (edge == offsets[from] || dsts[edge] != dsts[edge - 1])) {
+        candidates.push_back({weights[edge], edge, static_cast<node_id>(from)});
+      }
+    }
+  }
+
+  // sorted runs, one per thread, merged in pairs in rounds, ties broken by edge so the forest
+  // doesn't depend on the number of threads
+  auto lighter = [](const candidate& a, const candidate& b) {
+    if (a.weight < b.weight || b.weight < a.weight) {
+      return a.weight < b.weight;
+    }
+    return a.edge < b.edge;
+  };
+  ThreadPool& pool = ThreadPool::Shared();
+  constexpr std::size_t min_run = 4096;
+  std::size_t size = candidates.size();
+  std::size_t runs = threads == 0 ? pool.ThreadCount() : std::min(threads, pool.ThreadCount());
+  runs = std::max<std::size_t>(1, std::min(runs, size / min_run));
+  std::size_t width = (size + runs - 1) / runs;
+  auto sort_runs = [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t run = begin; run < end; ++run) {
+      std::sort(candidates.begin() + std::min(run * width, size),
+                candidates.begin() + std::min((run + 1) * width, size), lighter);
+    }
+  };
+  pool.ParallelFor(runs, 1, sort_runs, threads);
+  for (; width < size; width *= 2) {
+    auto merge_runs = [&](std::size_t begin, std::size_t end, std::size_t) {
+      for (std::size_t pair = begin; pair < end; ++pair) {
+        std::size_t first = 2 * pair * width;
+        std::inplace_merge(candidates.begin() + first,
+                           candidates.begin() + std::min(first + width, size),
+                           candidates.begin() + std::min(first + 2 * width, size), lighter);
+      }
+    };
+    pool.ParallelFor((size + 2 * width - 1) / (2 * width), 1, merge_runs, threads);
+  }
+
+  // union-find forest with path halving, an edge joining two trees is in the forest
+  std::vector<node_id> parents(count);
+  std::iota(parents.begin(), parents.end(), 0);
+  auto root = [&parents](node_id node) {
+    while (parents[node] != node) {
+      parents[node] = parents[parents[node]];
+      node = parents[node];
+    }
+    return node;
+  };
+  std::vector<const_iterator> forest;
+  for (const auto& [weight, edge, from] : candidates) {
+    if (forest.size() + 1 >= count) {
+      break;
+    }
+    node_id a = root(from);
+    node_id b = root(dsts[edge]);
+    if (a != b) {
+      parents[std::max(a, b)] = std::min(a, b);
+      forest.push_back(find(graph.Node(from), graph.Node(dsts[edge]), weight));
+    }
+  }
+  return forest;
+}
+
+template <typename N, typename E>
+gdwg::Graph<N, E>::components::components(std::shared_ptr<const snapshot> frozen)
+  : frozen_{std::move(frozen)}, labels_(frozen_->NodeCount(), no_node) {}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::node_id gdwg::Graph<N, E>::components::Label(const N& node) const {
+  if (!frozen_->IsNode(node)) {
+    throw std::out_of_range(
+        "Cannot call Graph::components::Label if node doesn't exist in the graph");
+  }
+  return labels_[frozen_->Id(node)];
+}
+
+template <typename N, typename E>
+bool gdwg::Graph<N, E>::IsReachable(const N& src, const N& dst) const {
+  if (!IsNode(src) || !IsNode(dst)) {
+    // not both nodes exist
+    throw std::out_of_range(
+        "Cannot call Graph::IsReachable if src or dst node don't exist in the graph");
+  }
+  if (!(src < dst) && !(dst < src)) {
+    return true;
+  }
+  auto cache = Reachability();
+  const snapshot& graph = *cache->frozen;
+  if (!graph.IsNode(src) || !graph.IsNode(dst)) {
+    // inserted since the index was built, without edges
+    return false;
+  }
+  return cache->index.Reaches(graph.Id(src), graph.Id(dst));
+}
+
+template <typename N, typename E>
+std::shared_ptr<const typename gdwg::Graph<N, E>::reachability>
+gdwg::Graph<N, E>::Reachability() const {
+  // concurrent readers may both build the index, either copy is correct
+  auto cache = std::atomic_load(&reachability_);
+  if (!cache) {
+    auto scc = StronglyConnectedComponents();
+    const snapshot& graph = *scc.frozen_;
+    cache = std::make_shared<const reachability>(reachability{
+        scc.frozen_, ReachabilityIndex{graph.Offsets(), graph.Dsts(), scc.labels_, scc.count_}});
+    std::atomic_store(&reachability_, cache);
+  }
+  return cache;
+}
+
+template <typename N, typename E>
+bool gdwg::Graph<N, E>::CachedReachable(const N& src, const N& dst) const {
+  auto cache = std::atomic_load(&reachability_);
+  if (!cache || !cache->frozen->IsNode(src) || !cache->frozen->IsNode(dst)) {
+    return !(src < dst) && !(dst < src);
+  }
+  return cache->index.Reaches(cache->frozen->Id(src), cache->frozen->Id(dst));
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::components gdwg::Graph<N, E>::StronglyConnectedComponents() const {
+  components result{Frozen()};
+  const snapshot& graph = *result.frozen_;
+  const auto& offsets = graph.Offsets();
+  const auto& dsts = graph.Dsts();
+  std::size_t count = graph.NodeCount();
+
+  // Tarjan, the call stack holds {node, next out-edge} instead of recursing
+  // the node stack holds visited nodes whose component is not finished
+  std::vector<node_id> index(count, no_node);
+  std::vector<node_id> low(count);
+  std::vector<unsigned char> on_stack(count, 0);
+  std::vector<node_id> stack;
+  std::vector<std::pair<node_id, std::size_t>> calls;
+  node_id next_index = 0;
+  node_id finished = 0;
+  auto visit = [&](node_id node) {
+    index[node] = low[node] = next_index++;
+    stack.push_back(node);
+    on_stack[node] = 1;
+    calls.emplace_back(node, offsets[node]);
+  };
+  for (node_id root = 0; root < count; ++root) {
+    if (index[root] != no_node) {
+      continue;
+    }
+    visit(root);
+    while (!calls.empty()) {
+      node_id node = calls.back().first;
+      std::size_t& edge = calls.back().second;
+      if (edge < offsets[node + 1]) {
+        node_id to = dsts[edge++];
+        if (index[to] == no_node) {
+          visit(to);
+        } else if (on_stack[to]) {
+          low[node] = std::min(low[node], index[to]);
+        }
+        continue;
+      }
+
+      // every edge of node is done, return to the caller
+      calls.pop_back();
+      if (!calls.empty()) {
+        node_id caller = calls.back().first;
+        low[caller] = std::min(low[caller], low[node]);
+      }
+      if (low[node] == index[node]) {
+        // node is the root of a component, which is the rest of the stack from node
+        node_id member;
+        do {
+          member = stack.back();
+          stack.pop_back();
+          on_stack[member] = 0;
+          result.labels_[member] = finished;
+        } while (member != node);
+        ++finished;
+      }
+    }
+  }
+
+  // components finish in reverse topological order
+  for (auto& label : result.labels_) {
+    label = finished - 1 - label;
+  }
+  result.count_ = finished;
+  return result;
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::components
+gdwg::Graph<N, E>::WeaklyConnectedComponents(std::size_t threads) const {
+  components result{Frozen()};
+  const snapshot& graph = *result.frozen_;
+  const auto& offsets = graph.Offsets();
+  const auto& dsts = graph.Dsts();
+  const auto& in_offsets = graph.InOffsets();
+  const auto& srcs = graph.Srcs();
+  std::size_t count = graph.NodeCount();
+
+  // union-find forest, a root is hooked under a smaller root with compare and swap, so the root
+  // of a component is its smallest node, and paths are shortened without locks
+  std::vector<std::atomic<node_id>> parents(count);
+  auto parent = [&parents](node_id node) { return parents[node].load(std::memory_order_relaxed); };
+  auto link = [&](node_id a, node_id b) {
+    node_id first = parent(a);
+    node_id second = parent(b);
+    while (first != second) {
+      node_id high = std::max(first, second);
+      node_id low = std::min(first, second);
+      node_id high_parent = parent(high);
+      if (high_parent == low ||
+          (high_parent == high &&
+           parents[high].compare_exchange_strong(high_parent, low, std::memory_order_relaxed))) {
+        break;
+      }
+      first = parent(parent(high));
+      second = parent(low);
+    }
+  };
+  constexpr std::size_t grain = 4096;
+  ThreadPool& pool = ThreadPool::Shared();
+  auto compress_range = [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t node = begin; node < end; ++node) {
+      while (parent(node) != parent(parent(node))) {
+        parents[node].store(parent(parent(node)), std::memory_order_relaxed);
+      }
+    }
+  };
+  for (node_id node = 0; node < count; ++node) {
+    parents[node].store(node, std::memory_order_relaxed);
+  }
+
+  // link the first few out-edges of every node, which mostly finds the largest component
+  constexpr std::size_t sampled_edges = 2;
+  for (std::size_t round = 0; round < sampled_edges; ++round) {
+    auto link_sampled = [&](std::size_t begin, std::size_t end, std::size_t) {
+      for (std::size_t node = begin; node < end; ++node) {
+        if (offsets[node] + round < offsets[node + 1]) {
+          link(static_cast<node_id>(node), dsts[offsets[node] + round]);
+        }
+      }
+    };
+    pool.ParallelFor(count, grain, link_sampled, threads);
+    pool.ParallelFor(count, grain, compress_range, threads);
+  }
+
+  // the most frequent root of a sample of nodes is most likely the largest component
+  // its nodes skip their remaining edges, an edge into it is still linked from the other side
+  node_id largest = no_node;
+  if (count > 0) {
+    std::vector<node_id> sample;
+    unsigned seed = 6771;
+    for (int i = 0; i < 1024; ++i) {
+      seed = seed * 1103515245 + 12345;
+      sample.push_back(parent(static_cast<node_id>(seed / 65536 % count)));
+    }
+    std::sort(sample.begin(), sample.end());
+    std::size_t best_run = 0;
+    for (std::size_t i = 0, j = 0; i < sample.size(); i = j) {
+      for (j = i; j < sample.size() && sample[j] == sample[i]; ++j) {
+      }
+      if (j - i > best_run) {
+        best_run = j - i;
+        largest = sample[i];
+      }
+    }
+  }
+  auto link_rest = [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t node = begin; node < end; ++node) {
+      if (parent(node) == largest) {
+        continue;
+      }
+      for (std::size_t edge = offsets[node] + sampled_edges; edge < offsets[node + 1]; ++edge) {
+        link(static_cast<node_id>(node), dsts[edge]);
+      }
+      for (std::size_t edge = in_offsets[node]; edge < in_offsets[node + 1]; ++edge) {
+        link(static_cast<node_id>(node), srcs[edge]);
+      }
+    }
+  };
+  pool.ParallelFor(count, grain, link_rest, threads);
+  pool.ParallelFor(count, grain, compress_range, threads);
+
+  // number the roots in order, each node then takes the label of its root
+  for (node_id node = 0; node < count; ++node) {
+    node_id root = parent(node);
+    result.labels_[node] = root == node ? static_cast<node_id>(result.count_++)
+                                        : result.labels_[root];
+  }
+  return result;
+}
+
+template <typename N, typename E>
+std::vector<std::reference_wrapper<const N>> gdwg::Graph<N, E>::TopologicalOrder() const {
+  auto frozen = Frozen();
+  const auto& offsets = frozen->Offsets();
+  const auto& dsts = frozen->Dsts();
+  const auto& in_offsets = frozen->InOffsets();
+  std::size_t count = frozen->NodeCount();
+
+  // Kahn, order doubles as the queue of nodes without remaining in-edges
+  std::vector<std::size_t> in_degrees(count);
+  std::vector<node_id> order;
+  order.reserve(count);
+  for (node_id node = 0; node < count; ++node) {
+    in_degrees[node] = in_offsets[node + 1] - in_offsets[node];
+    if (in_degrees[node] == 0) {
+      order.push_back(node);
+    }
+  }
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    node_id from = order[i];
+    for (std::size_t edge = offsets[from]; edge < offsets[from + 1]; ++edge) {
+      if (--in_degrees[dsts[edge]] == 0) {
+        order.push_back(dsts[edge]);
+      }
+    }
+  }
+  if (order.size() != count) {
+    // the nodes left over are on or after a cycle
+    throw std::runtime_error("Cannot call Graph::TopologicalOrder on a graph with a cycle");
+  }
+
+  std::vector<std::reference_wrapper<const N>> nodes;
+  nodes.reserve(count);
+  for (node_id id : order) {
+    nodes.push_back(std::cref(frozen->Node(id)));
+  }
+  return nodes;
+}
+
+template <typename N, typename E>
+std::vector<std::reference_wrapper<const N>> gdwg::Graph<N, E>::FindCycle() const {
+  auto frozen = Frozen();
+  const auto& offsets = frozen->Offsets();
+  const auto& dsts = frozen->Dsts();
+  std::size_t count = frozen->NodeCount();
+
+  // depth first search, an edge back to a node on the current path closes a cycle
+  // the path holds {node, next out-edge}, like the call stack of a recursive search
+  enum : unsigned char { unvisited, on_path, done };
+  std::vector<unsigned char> states(count, unvisited);
+  std::vector<std::pair<node_id, std::size_t>> path;
+  std::vector<std::reference_wrapper<const N>> cycle;
+  for (node_id root = 0; root < count && cycle.empty(); ++root) {
+    if (states[root] != unvisited) {
+      continue;
+    }
+    states[root] = on_path;
+    path.emplace_back(root, offsets[root]);
+    while (!path.empty() && cycle.empty()) {
+      node_id node = path.back().first;
+      std::size_t& edge = path.back().second;
+      if (edge == offsets[node + 1]) {
+        states[node] = done;
+        path.pop_back();
+        continue;
+      }
+
+      node_id to = dsts[edge++];
+      if (states[to] == unvisited) {
+        states[to] = on_path;
+        path.emplace_back(to, offsets[to]);
+      } else if (states[to] == on_path) {
+        auto first = std::find_if(path.begin(), path.end(),
+                                  [to](const auto& call) { return call.first == to; });
+        for (auto it = first; it != path.end(); ++it) {
+          cycle.push_back(std::cref(frozen->Node(it->first)));
+        }
+        cycle.push_back(std::cref(frozen->Node(to)));
+      }
+    }
+  }
+  return cycle;
+}
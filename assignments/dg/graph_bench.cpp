@@ -0,0 +1,271 @@
+/*
+
+  == Benchmark suite of gdwg::Graph ==
+
+ Every case runs on deterministic synthetic graphs, for Graph<int, int> and
+ Graph<std::string, double>, with 10^3 edges up to the largest edge count given on the command
+ line (10^6 by default, 10^7 needs several GB of memory). Each graph has a tenth as many nodes
+ as edges.
+
+ Results are written to stdout as JSON, one record per case and size, e.g.
+   bazel run -c opt //assignments/dg:graph_bench -- 10000000 > graph_bench.json
+
+ Read-only cases run first, then the cases that change the graph, on the same graph.
+ Per-operation cases run at most 10^5 operations. The path index is only built up to 10^5 edges,
+ and the all pairs distance table up to 10^3 nodes.
+
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+
+namespace {
+
+// sink keeps the optimiser from discarding results, printed at the end
+std::size_t sink = 0;
+
+// first record is printed without a leading comma
+bool first_record = true;
+
+// deterministic node and weight values for each graph type
+template <typename T>
+T MakeValue(int i);
+
+template <>
+int MakeValue<int>(int i) {
+  return i;
+}
+
+template <>
+double MakeValue<double>(int i) {
+  return i / 4.0;
+}
+
+template <>
+std::string MakeValue<std::string>(int i) {
+  // padded, so string order matches number order, like typical keys
+  std::string digits = std::to_string(i);
+  return "node-" + std::string(10 - digits.size(), '0') + digits;
+}
+
+// time fn() and print a JSON record, ops is the number of operations fn() performs
+template <typename F>
+void Run(const char* type, const char* name, int nodes, int edges, int ops, F fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  auto end = std::chrono::steady_clock::now();
+  double ns = std::chrono::duration<double, std::nano>(end - start).count();
+  std::printf("%s\n    {\"type\": \"%s\", \"case\": \"%s\", \"nodes\": %d, \"edges\": %d, "
+              "\"ops\": %d, \"total_ns\": %.0f, \"ns_per_op\": %.1f}",
+              first_record ? "" : ",", type, name, nodes, edges, ops, ns, ns / std::max(ops, 1));
+  first_record = false;
+}
+
+template <typename N, typename E>
+void BenchGraph(const char* type, int edges) {
+  int nodes = std::max(edges / 10, 10);
+  int ops = std::min(edges, 100000);
+  int node_ops = std::min(nodes / 4, 10000);
+  std::mt19937 rng{6771};
+  std::uniform_int_distribution<int> node_dist{0, nodes - 1};
+  std::uniform_int_distribution<int> weight_dist{0, 1000};
+
+  // edge list, and queries sampled from it
+  std::vector<std::tuple<N, N, E>> list;
+  list.reserve(edges);
+  for (int i = 0; i < edges; ++i) {
+    list.emplace_back(MakeValue<N>(node_dist(rng)), MakeValue<N>(node_dist(rng)),
+                      MakeValue<E>(weight_dist(rng)));
+  }
+  std::vector<std::tuple<N, N, E>> queries;
+  queries.reserve(ops);
+  for (int i = 0; i < ops; ++i) {
+    queries.push_back(list[rng() % list.size()]);
+  }
+
+  gdwg::Graph<N, E> g;
+  Run(type, "bulk_load", nodes, edges, edges,
+      [&] { g = gdwg::Graph<N, E>{list.cbegin(), list.cend()}; });
+  list.clear();
+  list.shrink_to_fit();
+
+  // read-only cases
+  Run(type, "find", nodes, edges, ops, [&] {
+    for (const auto& [src, dst, w] : queries) {
+      sink += g.find(src, dst, w) != g.end();
+    }
+  });
+  Run(type, "is_connected", nodes, edges, ops, [&] {
+    for (const auto& query : queries) {
+      sink += g.IsConnected(std::get<1>(query), std::get<0>(query));
+    }
+  });
+  Run(type, "get_connected", nodes, edges, ops, [&] {
+    for (const auto& query : queries) {
+      sink += g.GetConnected(std::get<0>(query)).size();
+    }
+  });
+  Run(type, "get_connected_view", nodes, edges, ops, [&] {
+    for (const auto& query : queries) {
+      for (const auto& dst : g.GetConnectedView(std::get<0>(query))) {
+        sink += dst < std::get<1>(query);
+      }
+    }
+  });
+  Run(type, "get_weights", nodes, edges, ops, [&] {
+    for (const auto& query : queries) {
+      sink += g.GetWeights(std::get<0>(query), std::get<1>(query)).size();
+    }
+  });
+  // lazy traversals stopped after a few nodes, as in queries that find their target early
+  Run(type, "bfs_first_10", nodes, edges, node_ops, [&] {
+    for (int i = 0; i < node_ops; ++i) {
+      auto bfs = g.Bfs(std::get<0>(queries[i]));
+      auto it = bfs.begin();
+      for (int j = 0; j < 10 && it != bfs.end(); ++j, ++it) {
+        sink += it.Depth();
+      }
+    }
+  });
+  Run(type, "dfs_first_10", nodes, edges, node_ops, [&] {
+    for (int i = 0; i < node_ops; ++i) {
+      auto dfs = g.Dfs(std::get<0>(queries[i]));
+      auto it = dfs.begin();
+      for (int j = 0; j < 10 && it != dfs.end(); ++j, ++it) {
+        sink += it.Depth();
+      }
+    }
+  });
+  Run(type, "iterate", nodes, edges, edges, [&] {
+    for (const auto& [src, dst, w] : g) {
+      sink += src < dst && w < E{};
+    }
+  });
+  Run(type, "freeze", nodes, edges, edges, [&] { sink += g.Freeze().EdgeCount(); });
+  Run(type, "shortest_paths", nodes, edges, 10, [&] {
+    for (int i = 0; i < 10; ++i) {
+      sink += g.ShortestPaths(std::get<0>(queries[i])).IsReachable(std::get<1>(queries[i]));
+    }
+  });
+  Run(type, "breadth_first_search", nodes, edges, 10, [&] {
+    for (int i = 0; i < 10; ++i) {
+      sink += g.BreadthFirstSearch(std::get<0>(queries[i])).IsReachable(std::get<1>(queries[i]));
+    }
+  });
+  Run(type, "strongly_connected_components", nodes, edges, edges,
+      [&] { sink += g.StronglyConnectedComponents().Count(); });
+  Run(type, "weakly_connected_components", nodes, edges, edges,
+      [&] { sink += g.WeaklyConnectedComponents().Count(); });
+  Run(type, "page_rank", nodes, edges, edges, [&] { sink += g.PageRank().Iterations(); });
+  Run(type, "count_triangles", nodes, edges, edges, [&] { sink += g.CountTriangles(); });
+  Run(type, "core_decomposition", nodes, edges, edges,
+      [&] { sink += g.CoreDecomposition().Degeneracy(); });
+  // exact betweenness searches from every node, so a sample of 100 srcs is timed
+  Run(type, "betweenness_sampled", nodes, edges, 100,
+      [&] { sink += g.Betweenness(false, 100).Scores().size(); });
+  Run(type, "weighted_betweenness_sampled", nodes, edges, 100,
+      [&] { sink += g.Betweenness(true, 100).Scores().size(); });
+  Run(type, "minimum_spanning_forest", nodes, edges, edges,
+      [&] { sink += g.MinimumSpanningForest().size(); });
+  Run(type, "max_flow", nodes, edges, 10, [&] {
+    for (int i = 0; i < 10; ++i) {
+      if (std::get<0>(queries[i]) != std::get<1>(queries[i])) {
+        sink += g.MaxFlow(std::get<0>(queries[i]), std::get<1>(queries[i])).CutEdges().size();
+      }
+    }
+  });
+  // the first query builds the reachability index, later ones reuse it
+  Run(type, "reachability_index", nodes, edges, edges,
+      [&] { sink += g.IsReachable(std::get<0>(queries[0]), std::get<1>(queries[0])); });
+  Run(type, "is_reachable", nodes, edges, ops, [&] {
+    for (const auto& query : queries) {
+      sink += g.IsReachable(std::get<1>(query), std::get<0>(query));
+    }
+  });
+  Run(type, "shortest_path", nodes, edges, 100, [&] {
+    for (int i = 0; i < 100; ++i) {
+      sink += g.ShortestPath(std::get<0>(queries[i]), std::get<1>(queries[i])).size();
+    }
+  });
+  // the synthetic graphs have no geometry, so A* runs without an estimate, like Dijkstra
+  Run(type, "a_star", nodes, edges, 100, [&] {
+    for (int i = 0; i < 100; ++i) {
+      sink += g.AStar(std::get<0>(queries[i]), std::get<1>(queries[i]), [](const N&) {
+                 return E{};
+               }).size();
+    }
+  });
+  // the distance table has nodes^2 entries, so it is only computed on the smaller graphs
+  if (nodes <= 1000) {
+    Run(type, "all_pairs_shortest_paths", nodes, edges, nodes,
+        [&] { sink += g.AllPairsShortestPaths().Distances().size(); });
+  }
+  // random graphs contract poorly, so the path index is only built on the smaller ones
+  if (edges <= 100000) {
+    gdwg::Graph<N, E> indexed = g;
+    Run(type, "build_path_index", nodes, edges, edges, [&] { indexed.BuildPathIndex(); });
+    Run(type, "indexed_shortest_path", nodes, edges, 100, [&] {
+      for (int i = 0; i < 100; ++i) {
+        sink += indexed.ShortestPath(std::get<0>(queries[i]), std::get<1>(queries[i])).size();
+      }
+    });
+  }
+  {
+    gdwg::Graph<N, E> copy;
+    Run(type, "copy", nodes, edges, edges, [&] { copy = g; });
+    Run(type, "equality", nodes, edges, edges, [&] { sink += copy == g; });
+  }
+
+  // cases that change the graph
+  Run(type, "insert_edge", nodes, edges, ops, [&] {
+    for (int i = 0; i < ops; ++i) {
+      sink += g.InsertEdge(MakeValue<N>(node_dist(rng)), MakeValue<N>(node_dist(rng)),
+                           MakeValue<E>(weight_dist(rng)));
+    }
+  });
+  Run(type, "erase", nodes, edges, ops, [&] {
+    for (const auto& [src, dst, w] : queries) {
+      sink += g.erase(src, dst, w);
+    }
+  });
+  Run(type, "replace", nodes, edges, node_ops, [&] {
+    for (int i = 0; i < node_ops; ++i) {
+      // nodes only exist if they appear in some edge
+      if (g.IsNode(MakeValue<N>(i))) {
+        sink += g.Replace(MakeValue<N>(i), MakeValue<N>(nodes + i));
+      }
+    }
+  });
+  Run(type, "merge_replace", nodes, edges, node_ops, [&] {
+    for (int i = 0; i < node_ops; ++i) {
+      N old_data = MakeValue<N>(node_ops + 2 * i);
+      N new_data = MakeValue<N>(node_ops + 2 * i + 1);
+      if (g.IsNode(old_data) && g.IsNode(new_data)) {
+        g.MergeReplace(old_data, new_data);
+        ++sink;
+      }
+    }
+  });
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  // optional argument, the largest edge count
+  int max_edges = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+  std::printf("{\n  \"benchmarks\": [");
+  for (int edges = 1000; edges <= max_edges; edges *= 10) {
+    BenchGraph<int, int>("Graph<int, int>", edges);
+    BenchGraph<std::string, double>("Graph<std::string, double>", edges);
+  }
+  std::printf("\n  ],\n  \"checksum\": %zu\n}\n", sink);
+}
@@ -13,8 +13,19 @@
 
 */
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <memory>
+#include <numeric>
+#include <set>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -27,6 +38,76 @@ using std::string;
 using std::tuple;
 using std::vector;
 
+// a heavy value that counts its copies, for checking how often insertion copies nodes and weights
+struct Counted {
+  explicit Counted(string v) : value{std::move(v)} {}
+  Counted(const Counted& other) : value{other.value} { ++copies; }
+  Counted(Counted&&) = default;
+  Counted& operator=(const Counted& other) {
+    value = other.value;
+    ++copies;
+    return *this;
+  }
+  Counted& operator=(Counted&&) = default;
+
+  friend bool operator<(const Counted& lhs, const Counted& rhs) { return lhs.value < rhs.value; }
+  friend bool operator==(const Counted& lhs, const Counted& rhs) { return lhs.value == rhs.value; }
+  friend bool operator!=(const Counted& lhs, const Counted& rhs) { return lhs.value != rhs.value; }
+
+  string value;
+  static int copies;
+};
+
+int Counted::copies = 0;
+
+namespace {
+
+// pseudo random numbers from a linear congruential generator, so the tests build the same graphs
+// on every platform
+class Lcg {
+ public:
+  explicit Lcg(unsigned seed = 6771) : seed_{seed} {}
+
+  unsigned operator()() { return (seed_ = seed_ * 1103515245 + 12345) / 65536 % 32768; }
+
+ private:
+  unsigned seed_;
+};
+
+// graph of nodes 0 to nodes - 1 and edges pseudo random edges, with cycles, parallel edges and
+// self loops, weight(r) is the weight of an edge drawn with the pseudo random number r
+template <typename E = int, typename F>
+Graph<int, E> RandomGraph(int nodes, int edges, F weight, Lcg& next) {
+  Graph<int, E> g;
+  for (int i = 0; i < nodes; ++i) {
+    g.InsertNode(i);
+  }
+  for (int i = 0; i < edges; ++i) {
+    int src = next() % nodes;
+    int dst = next() % nodes;
+    g.InsertEdge(src, dst, weight(next()));
+  }
+  return g;
+}
+
+template <typename E = int, typename F>
+Graph<int, E> RandomGraph(int nodes, int edges, F weight, unsigned seed = 6771) {
+  Lcg next{seed};
+  return RandomGraph<E>(nodes, edges, weight, next);
+}
+
+// length of a path through the lightest edges between its nodes
+template <typename E, typename Path>
+E PathLength(const Graph<int, E>& g, const Path& path) {
+  E total{};
+  for (std::size_t i = 1; i < path.size(); ++i) {
+    total += g.GetWeights(path[i - 1], path[i]).front();
+  }
+  return total;
+}
+
+}  // namespace
+
 SCENARIO("Test regular constructors") {
   GIVEN("No arguments") {
     WHEN("Construct an empty graph") {
@@ -72,6 +153,30 @@ SCENARIO("Test regular constructors") {
     }
   }
 
+  GIVEN("an unsorted list of edge tuples with duplications") {
+    std::list<tuple<string, string, int>> l{{"d", "c", 3}, {"a", "b", 2}, {"a", "b", 1},
+                                            {"d", "c", 3}, {"b", "a", 2}, {"a", "e", 2}};
+    WHEN("Construct graph using iterators of the list") {
+      Graph<string, int> g{l.begin(), l.end()};
+      THEN("every node and distinct edge is in the graph, in sorted order") {
+        REQUIRE(g.GetNodes() == vector<string>{"a", "b", "c", "d", "e"});
+        REQUIRE(g.GetWeights("a", "b") == vector<int>{1, 2});
+        REQUIRE(g.GetWeights("b", "a") == vector<int>{2});
+        REQUIRE(g.GetWeights("d", "c") == vector<int>{3});
+        REQUIRE(g.GetConnected("a") == vector<string>{"b", "e"});
+        REQUIRE(std::distance(g.begin(), g.end()) == 5);
+      }
+    }
+  }
+
+  GIVEN("a set of nodes") {
+    std::set<int> s{3, 1, 2};
+    WHEN("Construct graph using iterators of the set") {
+      Graph<int, int> g{s.begin(), s.end()};
+      THEN("Nodes can be found") { REQUIRE(g.GetNodes() == vector<int>{1, 2, 3}); }
+    }
+  }
+
   GIVEN("a list of nodes as individual variables") {
     int int1 = 1;
     int int2 = 2;
@@ -146,6 +251,37 @@ SCENARIO("Test copy/move constructor") {
   }
 }
 
+SCENARIO("Test copies of a graph with interned nodes") {
+  GIVEN("a graph and its copy") {
+    Graph<string, int> g{"a", "b", "c"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("b", "c", 2);
+    Graph<string, int> g_copy{g};
+    WHEN("deleting and inserting nodes in the original graph") {
+      g.DeleteNode("b");
+      g.InsertNode("d");
+      g.InsertEdge("d", "a", 3);
+      THEN("the copy is not affected") {
+        REQUIRE(g_copy.GetNodes() == vector<string>{"a", "b", "c"});
+        REQUIRE(g_copy.GetWeights("a", "b") == vector<int>{1});
+        REQUIRE(g_copy.GetWeights("b", "c") == vector<int>{2});
+        REQUIRE_FALSE(g_copy.IsNode("d"));
+        REQUIRE(g.GetNodes() == vector<string>{"a", "c", "d"});
+        REQUIRE(g.GetWeights("d", "a") == vector<int>{3});
+        REQUIRE(g != g_copy);
+      }
+    }
+  }
+
+  GIVEN("the type of a connection") {
+    using connection = Graph<string, int>::connection;
+    using shared_connection = tuple<std::shared_ptr<string>, std::shared_ptr<string>, int>;
+    THEN("it stores node handles, smaller than a pair of shared pointers") {
+      REQUIRE(sizeof(connection) < sizeof(shared_connection));
+    }
+  }
+}
+
 SCENARIO("Test copy/move assignments") {
   GIVEN("a graph with some nodes and edges, and another empty graph") {
     vector<tuple<string, string, int>> v;
@@ -244,6 +380,53 @@ SCENARIO("Test node insertion methods") {
   }
 }
 
+SCENARIO("Test move-aware node and edge insertion") {
+  GIVEN("an empty graph of heavy nodes and weights") {
+    Graph<Counted, Counted> g;
+    Counted::copies = 0;
+    WHEN("insert nodes by moving and by emplacing") {
+      bool moved = g.InsertNode(Counted{string(100, 'a')});
+      bool emplaced = g.EmplaceNode(string(100, 'b'));
+      bool emplaced_again = g.EmplaceNode(string(100, 'b'));
+      THEN("the nodes are inserted without any copy") {
+        REQUIRE(moved);
+        REQUIRE(emplaced);
+        REQUIRE_FALSE(emplaced_again);
+        REQUIRE(g.IsNode(Counted{string(100, 'a')}));
+        REQUIRE(g.IsNode(Counted{string(100, 'b')}));
+        REQUIRE(Counted::copies == 0);
+      }
+    }
+    WHEN("insert a node by const reference") {
+      const Counted node{"a"};
+      g.InsertNode(node);
+      THEN("the node is copied only once") { REQUIRE(Counted::copies == 1); }
+    }
+  }
+
+  GIVEN("a graph of heavy nodes and weights with two nodes") {
+    Graph<Counted, Counted> g;
+    g.EmplaceNode("a");
+    g.EmplaceNode("b");
+    Counted::copies = 0;
+    WHEN("insert an edge by moving the weight") {
+      bool inserted = g.InsertEdge(Counted{"a"}, Counted{"b"}, Counted{"w"});
+      THEN("no node is copied, the weight is copied once into the reverse index") {
+        REQUIRE(inserted);
+        REQUIRE(g.find(Counted{"a"}, Counted{"b"}, Counted{"w"}) != g.end());
+        REQUIRE(Counted::copies == 1);
+      }
+    }
+    WHEN("insert an edge by const reference of the weight") {
+      const Counted weight{"w"};
+      g.InsertEdge(Counted{"a"}, Counted{"b"}, weight);
+      THEN("no node is copied, the weight is copied once into each index") {
+        REQUIRE(Counted::copies == 2);
+      }
+    }
+  }
+}
+
 SCENARIO("Test node deletion methods") {
   GIVEN("a graph with many nodes") {
     Graph<int, int> g;
@@ -395,6 +578,49 @@ SCENARIO("Test node clear and getter methods") {
   }
 }
 
+SCENARIO("Test views of nodes, connected nodes and weights") {
+  GIVEN("a graph with parallel edges") {
+    Graph<int, char> g{4, 1, 3, 2};
+    g.InsertEdge(1, 3, 'c');
+    g.InsertEdge(1, 2, 'b');
+    g.InsertEdge(1, 3, 'a');
+    g.InsertEdge(1, 1, 'a');
+    WHEN("get the views") {
+      auto nodes = g.GetNodesView();
+      auto connected = g.GetConnectedView(1);
+      auto weights = g.GetWeightsView(1, 3);
+      THEN("they are in sorted order without duplication, same as the vectors") {
+        REQUIRE(vector<int>(nodes.begin(), nodes.end()) == vector<int>{1, 2, 3, 4});
+        REQUIRE(vector<int>(connected.begin(), connected.end()) == vector<int>{1, 2, 3});
+        REQUIRE(vector<char>(weights.begin(), weights.end()) == vector<char>{'a', 'c'});
+        REQUIRE(vector<int>(nodes.begin(), nodes.end()) == g.GetNodes());
+        REQUIRE(vector<int>(connected.begin(), connected.end()) == g.GetConnected(1));
+        REQUIRE(vector<char>(weights.begin(), weights.end()) == g.GetWeights(1, 3));
+      }
+      THEN("they refer to the values stored in the graph") {
+        REQUIRE(&*connected.begin() == &*nodes.begin());
+        REQUIRE(&*weights.begin() == &std::get<2>(*g.find(1, 3, 'a')));
+      }
+    }
+    WHEN("get the views of a node without edges") {
+      THEN("the views are empty") {
+        REQUIRE(g.GetConnectedView(4).empty());
+        REQUIRE(g.GetWeightsView(4, 1).empty());
+        REQUIRE(g.GetWeightsView(3, 1).empty());
+      }
+    }
+    WHEN("get the views of a node not in the graph, exception is thrown") {
+      THEN("the messages are the same as the vector getters") {
+        REQUIRE_THROWS_WITH(g.GetConnectedView(5),
+                            "Cannot call Graph::GetConnected if src doesn't exist in the graph");
+        REQUIRE_THROWS_WITH(
+            g.GetWeightsView(1, 5),
+            "Cannot call Graph::GetWeights if src or dst node don't exist in the graph");
+      }
+    }
+  }
+}
+
 SCENARIO("Test edge insertion  methods") {
   GIVEN("an graph with some nodes") {
     Graph<int, char> g{1, 2, 3};
@@ -494,6 +720,36 @@ SCENARIO("Test deletion methods that affects edges") {
       THEN("the edge is not in the graph") { REQUIRE_FALSE(g.IsConnected(1, 2)); }
     }
   }
+
+  GIVEN("an graph with some nodes and parallel edges") {
+    Graph<int, char> g{1, 2, 3};
+    g.InsertEdge(1, 2, 'a');
+    g.InsertEdge(1, 2, 'b');
+    g.InsertEdge(1, 3, 'b');
+    g.InsertEdge(2, 1, 'b');
+    WHEN("find one of the parallel edges") {
+      auto it = g.find(1, 2, 'b');
+      THEN("the iterator points to that edge") {
+        REQUIRE(std::get<0>(*it) == 1);
+        REQUIRE(std::get<1>(*it) == 2);
+        REQUIRE(std::get<2>(*it) == 'b');
+        REQUIRE(g.find(1, 2, 'c') == g.cend());
+      }
+    }
+    WHEN("erase one of the parallel edges twice") {
+      bool erased = g.erase(1, 2, 'b');
+      bool erased_again = g.erase(1, 2, 'b');
+      THEN("only that edge is removed, the other edges are not affected") {
+        REQUIRE(erased);
+        REQUIRE_FALSE(erased_again);
+        REQUIRE(g.find(1, 2, 'b') == g.cend());
+        REQUIRE(g.find(1, 2, 'a') != g.cend());
+        REQUIRE(g.find(1, 3, 'b') != g.cend());
+        REQUIRE(g.find(2, 1, 'b') != g.cend());
+        REQUIRE(g.GetWeights(1, 2) == vector<char>{'a'});
+      }
+    }
+  }
 }
 
 SCENARIO("Test replace and merge replace methods with edges") {
@@ -567,6 +823,55 @@ SCENARIO("Test replace and merge replace methods with edges") {
   }
 }
 
+SCENARIO("Test incoming edges") {
+  GIVEN("a graph with in-edges, out-edges and a self loop on one node") {
+    Graph<int, char> g{1, 2, 3, 4};
+    g.InsertEdge(1, 2, 'a');
+    g.InsertEdge(1, 2, 'b');
+    g.InsertEdge(3, 2, 'a');
+    g.InsertEdge(2, 2, 'c');
+    g.InsertEdge(2, 4, 'd');
+    g.InsertEdge(4, 3, 'e');
+    WHEN("get the incoming nodes") {
+      THEN("nodes with an edge to each node are found in sorted order without duplication") {
+        REQUIRE(g.GetIncoming(1).empty());
+        REQUIRE(g.GetIncoming(2) == vector<int>{1, 2, 3});
+        REQUIRE(g.GetIncoming(3) == vector<int>{4});
+        REQUIRE(g.GetIncoming(4) == vector<int>{2});
+        REQUIRE_THROWS_WITH(g.GetIncoming(5),
+                            "Cannot call Graph::GetIncoming if dst doesn't exist in the graph");
+      }
+    }
+    WHEN("delete the node") {
+      g.DeleteNode(2);
+      THEN("all of its edges are removed from both directions") {
+        REQUIRE(g.GetConnected(1).empty());
+        REQUIRE(g.GetConnected(3).empty());
+        REQUIRE(g.GetIncoming(4).empty());
+        REQUIRE(g.GetIncoming(3) == vector<int>{4});
+        REQUIRE(std::distance(g.begin(), g.end()) == 1);
+      }
+    }
+    WHEN("erase edges by value and by iterator") {
+      g.erase(1, 2, 'a');
+      g.erase(g.find(1, 2, 'b'));
+      THEN("the nodes are no longer incoming") { REQUIRE(g.GetIncoming(2) == vector<int>{2, 3}); }
+    }
+    WHEN("merge replace the node to another node") {
+      g.MergeReplace(2, 3);
+      THEN("its edges in both directions and its self loop are moved to the other node") {
+        REQUIRE_FALSE(g.IsNode(2));
+        REQUIRE(g.GetWeights(1, 3) == vector<char>{'a', 'b'});
+        REQUIRE(g.GetWeights(3, 3) == vector<char>{'a', 'c'});
+        REQUIRE(g.GetWeights(3, 4) == vector<char>{'d'});
+        REQUIRE(g.GetIncoming(3) == vector<int>{1, 3, 4});
+        REQUIRE(g.GetIncoming(4) == vector<int>{3});
+        REQUIRE(std::distance(g.begin(), g.end()) == 6);
+      }
+    }
+  }
+}
+
 SCENARIO("Test begin iterators and dereferences") {
   GIVEN("an graph with no edge") {
     Graph<int, char> g{1, 2, 3};
@@ -789,6 +1094,33 @@ SCENARIO("Test output functions") {
       }
     }
   }
+
+  GIVEN("A graph with self loops and nodes without edges between other nodes") {
+    Graph<string, double> g{"c", "a", "b", "d"};
+    g.InsertEdge("c", "c", 1.5);
+    g.InsertEdge("a", "d", 2);
+    g.InsertEdge("a", "a", 0.25);
+    g.InsertEdge("c", "a", -1);
+    g.InsertEdge("a", "d", 1);
+
+    THEN("its output lists every node once, with its edges in sorted order") {
+      std::stringstream ss;
+      ss << g;
+      REQUIRE(ss.str() == "a (\n"
+                          "  a | 0.25\n"
+                          "  d | 1\n"
+                          "  d | 2\n"
+                          ")\n"
+                          "b (\n"
+                          ")\n"
+                          "c (\n"
+                          "  a | -1\n"
+                          "  c | 1.5\n"
+                          ")\n"
+                          "d (\n"
+                          ")\n");
+    }
+  }
 }
 
 SCENARIO("Test equal operators") {
@@ -868,3 +1200,1388 @@ SCENARIO("Test equal operators") {
     }
   }
 }
+
+SCENARIO("Test frozen snapshots") {
+  GIVEN("a graph with some nodes and edges") {
+    Graph<string, int> g{"d", "a", "c", "b"};
+    g.InsertEdge("c", "a", 4);
+    g.InsertEdge("a", "c", 2);
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("a", "c", 1);
+    g.InsertEdge("d", "d", 5);
+    WHEN("freezing the graph") {
+      auto frozen = g.Freeze();
+      THEN("nodes are numbered in sorted order and edges are stored by src") {
+        REQUIRE(frozen.NodeCount() == 4);
+        REQUIRE(frozen.EdgeCount() == 5);
+        REQUIRE(frozen.Node(0) == "a");
+        REQUIRE(frozen.Node(3) == "d");
+        REQUIRE(frozen.Id("c") == 2);
+        REQUIRE_FALSE(frozen.IsNode("e"));
+        REQUIRE_THROWS_WITH(frozen.Id("e"),
+                            "Cannot call Graph::snapshot::Id on a node that doesn't exist");
+        REQUIRE(frozen.Offsets() == vector<std::size_t>{0, 3, 3, 4, 5});
+        REQUIRE(frozen.Dsts() == vector<Graph<string, int>::node_id>{1, 2, 2, 0, 3});
+        REQUIRE(frozen.Weights() == vector<int>{1, 1, 2, 4, 5});
+        REQUIRE(frozen.InOffsets() == vector<std::size_t>{0, 1, 2, 4, 5});
+        REQUIRE(frozen.Srcs() == vector<Graph<string, int>::node_id>{2, 0, 0, 0, 3});
+        REQUIRE(frozen.InWeights() == vector<int>{4, 1, 1, 2, 5});
+      }
+      THEN("iterating the snapshot gives the same edges as iterating the graph") {
+        vector<tuple<string, string, int>> from_graph{g.begin(), g.end()};
+        vector<tuple<string, string, int>> from_snapshot{frozen.begin(), frozen.end()};
+        vector<tuple<string, string, int>> reversed{frozen.rbegin(), frozen.rend()};
+        std::reverse(reversed.begin(), reversed.end());
+        REQUIRE(from_snapshot == from_graph);
+        REQUIRE(reversed == from_graph);
+      }
+    }
+    WHEN("freezing the graph, then changing the graph") {
+      auto frozen = g.Freeze();
+      g.DeleteNode("a");
+      g.InsertEdge("b", "c", 3);
+      THEN("the snapshot is not affected") {
+        REQUIRE(frozen.NodeCount() == 4);
+        REQUIRE(frozen.Node(0) == "a");
+        REQUIRE(std::get<1>(*frozen.begin()) == "b");
+        REQUIRE(frozen.Offsets() == vector<std::size_t>{0, 3, 3, 4, 5});
+      }
+    }
+  }
+
+  GIVEN("a graph whose first, middle and last nodes have no out-edges") {
+    Graph<int, int> g{0, 1, 2, 3, 4, 5};
+    g.InsertEdge(1, 0, 1);
+    g.InsertEdge(1, 5, 2);
+    g.InsertEdge(4, 4, 3);
+    WHEN("iterating the snapshot in an explicit loop") {
+      auto frozen = g.Freeze();
+      vector<tuple<int, int, int>> forward;
+      for (auto it = frozen.cbegin(); it != frozen.cend(); ++it) {
+        forward.emplace_back(*it);
+      }
+      vector<tuple<int, int, int>> backward;
+      for (auto it = frozen.cend(); it != frozen.cbegin();) {
+        backward.emplace_back(*--it);
+      }
+      THEN("every edge is visited once with its src") {
+        vector<tuple<int, int, int>> expected{{1, 0, 1}, {1, 5, 2}, {4, 4, 3}};
+        REQUIRE(forward == expected);
+        std::reverse(backward.begin(), backward.end());
+        REQUIRE(backward == expected);
+      }
+    }
+  }
+
+  GIVEN("an empty graph") {
+    Graph<int, int> g;
+    WHEN("freezing the graph") {
+      auto frozen = g.Freeze();
+      THEN("the snapshot is empty") {
+        REQUIRE(frozen.begin() == frozen.end());
+        REQUIRE(frozen.Offsets() == vector<std::size_t>{0});
+      }
+    }
+  }
+}
+
+SCENARIO("Test shortest paths") {
+  GIVEN("a weighted graph with parallel edges and an unreachable node") {
+    Graph<string, int> g{"a", "b", "c", "d", "e"};
+    g.InsertEdge("a", "b", 4);
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("a", "c", 5);
+    g.InsertEdge("b", "c", 1);
+    g.InsertEdge("c", "d", 2);
+    g.InsertEdge("b", "d", 7);
+    g.InsertEdge("d", "a", 1);
+    WHEN("get the shortest paths from a") {
+      auto paths = g.ShortestPaths("a");
+      THEN("distances use the lightest parallel edge, unreachable nodes have no path") {
+        REQUIRE(paths.Source() == "a");
+        REQUIRE(paths.Distance("a") == 0);
+        REQUIRE(paths.Distance("b") == 1);
+        REQUIRE(paths.Distance("c") == 2);
+        REQUIRE(paths.Distance("d") == 4);
+        REQUIRE_FALSE(paths.IsReachable("e"));
+        REQUIRE(paths.Path("e").empty());
+        REQUIRE_THROWS_WITH(paths.Distance("e"),
+                            "Cannot call Graph::shortest_paths::Distance if dst is unreachable");
+        auto path = paths.Path("d");
+        REQUIRE(vector<string>(path.begin(), path.end()) == vector<string>{"a", "b", "c", "d"});
+      }
+    }
+    WHEN("get the shortest path between two nodes") {
+      auto path = g.ShortestPath("b", "a");
+      THEN("the nodes on the path are in order, and refer to the nodes in the graph") {
+        REQUIRE(vector<string>(path.begin(), path.end()) == vector<string>{"b", "c", "d", "a"});
+        REQUIRE(&path.front().get() == &*std::next(g.GetNodesView().begin()));
+        REQUIRE(g.ShortestPath("a", "a").size() == 1);
+        REQUIRE(g.ShortestPath("a", "e").empty());
+      }
+    }
+    WHEN("the graph changes after a search") {
+      auto paths = g.ShortestPaths("a");
+      g.InsertEdge("a", "d", 1);
+      g.DeleteNode("c");
+      THEN("new searches see the change, the old result is not affected") {
+        REQUIRE(g.ShortestPaths("a").Distance("d") == 1);
+        REQUIRE(paths.Distance("d") == 4);
+        REQUIRE(paths.Path("c").size() == 3);
+      }
+    }
+    WHEN("search from or to a node not in the graph, exception is thrown") {
+      THEN("the messages name the method") {
+        REQUIRE_THROWS_WITH(g.ShortestPaths("f"),
+                            "Cannot call Graph::ShortestPaths if src doesn't exist in the graph");
+        REQUIRE_THROWS_WITH(
+            g.ShortestPath("a", "f"),
+            "Cannot call Graph::ShortestPath if src or dst node don't exist in the graph");
+      }
+    }
+  }
+
+  GIVEN("a graph with a negative weight") {
+    Graph<int, double> g{1, 2};
+    g.InsertEdge(1, 2, -0.5);
+    THEN("the search throws once it reaches the edge") {
+      REQUIRE_THROWS_WITH(g.ShortestPaths(1),
+                          "Cannot call Graph::ShortestPaths on negative weights");
+      REQUIRE(g.ShortestPaths(2).IsReachable(2));
+      REQUIRE_THROWS_WITH(g.BuildPathIndex(),
+                          "Cannot call Graph::BuildPathIndex on negative weights");
+    }
+  }
+
+  GIVEN("a path index, then an edge with a negative weight") {
+    Graph<int, double> g{1, 2, 3};
+    g.InsertEdge(1, 2, 0.5);
+    g.BuildPathIndex();
+    g.InsertEdge(2, 3, -0.5);
+    THEN("rebuilding the index for a search throws naming the search") {
+      REQUIRE_THROWS_WITH(g.ShortestPath(1, 3),
+                          "Cannot call Graph::ShortestPath on negative weights");
+    }
+  }
+
+  GIVEN("a pseudo random graph with cycles, parallel edges and self loops") {
+    Lcg next;
+    auto g = RandomGraph(40, 120, [](unsigned r) { return r % 20; }, next);
+
+    // lengths of paths checked against Dijkstra from every src
+    auto matches_dijkstra = [&g] {
+      for (int src = 0; src < 40; ++src) {
+        auto paths = g.ShortestPaths(src);
+        for (int dst = 0; dst < 40; ++dst) {
+          auto path = g.ShortestPath(src, dst);
+          if (path.empty() == paths.IsReachable(dst) ||
+              (!path.empty() && (path.front() != src || path.back() != dst ||
+                                 PathLength(g, path) != paths.Distance(dst)))) {
+            return false;
+          }
+        }
+      }
+      return true;
+    };
+    WHEN("paths are searched from both ends") {
+      THEN("they are as short as a one sided search") { REQUIRE(matches_dijkstra()); }
+    }
+    WHEN("paths are searched on the path index") {
+      g.BuildPathIndex();
+      THEN("shortcuts are unpacked into the same lengths") { REQUIRE(matches_dijkstra()); }
+    }
+    WHEN("the graph is too dense to contract fully") {
+      for (int i = 0; i < 1200; ++i) {
+        g.InsertEdge(next() % 40, next() % 40, next() % 20);
+      }
+      auto frozen = g.Freeze();
+      gdwg::ContractionHierarchy<int> index{frozen.Offsets(), frozen.Dsts(), frozen.Weights()};
+      THEN("the uncontracted core is searched in every direction") {
+        REQUIRE(index.CoreSize() > 0);
+        bool same = true;
+        for (int src = 0; src < 40; ++src) {
+          auto paths = g.ShortestPaths(src);
+          for (int dst = 0; dst < 40; ++dst) {
+            vector<int> path;
+            for (auto id : index.Path(frozen.Id(src), frozen.Id(dst))) {
+              path.push_back(frozen.Node(id));
+            }
+            same = same && path.empty() != paths.IsReachable(dst) &&
+                   (path.empty() || PathLength(g, path) == paths.Distance(dst));
+          }
+        }
+        REQUIRE(same);
+        REQUIRE(matches_dijkstra());
+      }
+    }
+    WHEN("the graph changes after building the path index") {
+      g.BuildPathIndex();
+      g.InsertEdge(0, 39, 0);
+      g.erase(g.begin());
+      THEN("the index is rebuilt for the new graph") {
+        REQUIRE(g.ShortestPath(0, 39).size() == 2);
+        REQUIRE(matches_dijkstra());
+      }
+    }
+  }
+}
+
+SCENARIO("Test A* search") {
+  GIVEN("a grid with weights of at least one, numbered row by row") {
+    const int side = 30;
+    Graph<int, int> g;
+    for (int i = 0; i < side * side; ++i) {
+      g.InsertNode(i);
+    }
+    Lcg next;
+    for (int y = 0; y < side; ++y) {
+      for (int x = 0; x < side; ++x) {
+        int node = y * side + x;
+        if (x + 1 < side) {
+          g.InsertEdge(node, node + 1, 1 + next() % 5);
+          g.InsertEdge(node + 1, node, 1 + next() % 5);
+        }
+        if (y + 1 < side) {
+          g.InsertEdge(node, node + side, 1 + next() % 5);
+          g.InsertEdge(node + side, node, 1 + next() % 5);
+        }
+      }
+    }
+    // Manhattan distance, consistent since every step changes it by one
+    int calls = 0;
+    auto towards = [side, &calls](int dst) {
+      return [side, dst, &calls](int node) {
+        ++calls;
+        return std::abs(node % side - dst % side) + std::abs(node / side - dst / side);
+      };
+    };
+
+    WHEN("searching with the Manhattan distance") {
+      THEN("the paths are as short as Dijkstra's") {
+        for (int i = 0; i < 20; ++i) {
+          int src = next() % (side * side);
+          int dst = next() % (side * side);
+          auto path = g.AStar(src, dst, towards(dst));
+          REQUIRE(path.front() == src);
+          REQUIRE(path.back() == dst);
+          REQUIRE(PathLength(g, path) == g.ShortestPaths(src).Distance(dst));
+        }
+      }
+    }
+    WHEN("the dst is close by") {
+      auto path = g.AStar(0, 3, towards(3));
+      THEN("only a corner of the grid is reached") {
+        REQUIRE(PathLength(g, path) == g.ShortestPaths(0).Distance(3));
+        REQUIRE(calls < side * side / 4);
+      }
+    }
+    WHEN("searching from a node to itself") {
+      auto path = g.AStar(7, 7, towards(7));
+      THEN("the path is the node") {
+        REQUIRE(vector<int>(path.begin(), path.end()) == vector<int>{7});
+      }
+    }
+  }
+
+  GIVEN("a pseudo random graph with cycles, parallel edges and self loops") {
+    auto g = RandomGraph(40, 120, [](unsigned r) { return r % 20; });
+    auto zero = [](int) { return 0; };
+    WHEN("searching without an estimate") {
+      THEN("every path is as short as Dijkstra's, and unreachable ones are empty") {
+        bool same = true;
+        for (int src = 0; src < 40; ++src) {
+          auto paths = g.ShortestPaths(src);
+          for (int dst = 0; dst < 40; ++dst) {
+            auto path = g.AStar(src, dst, zero);
+            same = same && path.empty() != paths.IsReachable(dst) &&
+                   (path.empty() || PathLength(g, path) == paths.Distance(dst));
+          }
+        }
+        REQUIRE(same);
+      }
+    }
+    WHEN("a search throws") {
+      g.InsertEdge(0, 1, -1);
+      THEN("later searches start clean") {
+        REQUIRE_THROWS_WITH(g.AStar(0, 39, zero), "Cannot call Graph::AStar on negative weights");
+        REQUIRE_THROWS_WITH(g.AStar(0, 40, zero),
+                            "Cannot call Graph::AStar if src or dst node don't exist in the graph");
+        g.erase(0, 1, -1);
+        auto paths = g.ShortestPaths(0);
+        for (int dst = 0; dst < 40; ++dst) {
+          REQUIRE(g.AStar(0, dst, zero).empty() != paths.IsReachable(dst));
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Test all pairs shortest paths") {
+  GIVEN("a graph with a negative weight, a parallel edge, a self loop and an unreachable node") {
+    Graph<string, int> g{"a", "b", "c", "d", "e"};
+    g.InsertEdge("a", "b", 4);
+    g.InsertEdge("a", "b", 3);
+    g.InsertEdge("a", "c", 5);
+    g.InsertEdge("b", "c", -2);
+    g.InsertEdge("c", "d", 2);
+    g.InsertEdge("d", "a", 1);
+    g.InsertEdge("d", "d", 7);
+    WHEN("computing the table") {
+      auto table = g.AllPairsShortestPaths();
+      THEN("every pair has its shortest distance") {
+        REQUIRE(table.Distance("a", "a") == 0);
+        REQUIRE(table.Distance("a", "c") == 1);
+        REQUIRE(table.Distance("a", "d") == 3);
+        REQUIRE(table.Distance("c", "b") == 6);
+        REQUIRE(table.Distance("d", "c") == 2);
+        REQUIRE_FALSE(table.IsReachable("a", "e"));
+        REQUIRE(table.IsReachable("e", "e"));
+        REQUIRE(table.Distances()[table.Snapshot().Id("b") * 5 + table.Snapshot().Id("e")] ==
+                Graph<string, int>::distance_table::Unreachable());
+        REQUIRE_THROWS_WITH(table.Distance("a", "e"),
+                            "Cannot call Graph::distance_table::Distance if dst is unreachable");
+        REQUIRE_THROWS_WITH(table.IsReachable("a", "f"),
+                            "Cannot call Graph::distance_table::IsReachable if src or dst node "
+                            "don't exist in the graph");
+      }
+    }
+    WHEN("a cycle is negative") {
+      g.InsertEdge("c", "a", -2);
+      THEN("computing the table throws") {
+        REQUIRE_THROWS_WITH(g.AllPairsShortestPaths(),
+                            "Cannot call Graph::AllPairsShortestPaths on a graph with a negative "
+                            "cycle");
+      }
+    }
+  }
+
+  GIVEN("pseudo random graphs over several tiles, one without and one with negative weights") {
+    const int count = 150;
+    Lcg next;
+    auto g = RandomGraph<double>(count, 600, [](unsigned r) { return (r % 40) / 4.0; }, next);
+    Graph<int, int> acyclic;
+    for (int i = 0; i < count; ++i) {
+      acyclic.InsertNode(i);
+    }
+    for (int i = 0; i < 600; ++i) {
+      int a = next() % count;
+      int b = next() % count;
+      if (a != b) {
+        acyclic.InsertEdge(std::min(a, b), std::max(a, b), static_cast<int>(next() % 20) - 5);
+      }
+    }
+
+    // Bellman-Ford from every src, as the acyclic graph has negative weights
+    auto bellman_ford = [&acyclic, count](int src) {
+      const int none = std::numeric_limits<int>::max();
+      vector<int> distances(count, none);
+      distances[src] = 0;
+      for (int round = 0; round < count; ++round) {
+        for (const auto& [from, to, weight] : acyclic) {
+          if (distances[from] != none && distances[from] + weight < distances[to]) {
+            distances[to] = distances[from] + weight;
+          }
+        }
+      }
+      return distances;
+    };
+
+    for (std::size_t threads : {1, 4}) {
+      WHEN("computing the tables on " + std::to_string(threads) + " threads") {
+        auto table = g.AllPairsShortestPaths(threads);
+        auto acyclic_table = acyclic.AllPairsShortestPaths(threads);
+        THEN("the distances match single source searches") {
+          bool same = true;
+          for (int src = 0; src < count; ++src) {
+            auto paths = g.ShortestPaths(src);
+            auto distances = bellman_ford(src);
+            for (int dst = 0; dst < count; ++dst) {
+              same = same && table.IsReachable(src, dst) == paths.IsReachable(dst) &&
+                     (!paths.IsReachable(dst) || table.Distance(src, dst) == paths.Distance(dst));
+              same = same && acyclic_table.IsReachable(src, dst) ==
+                                 (distances[dst] != std::numeric_limits<int>::max()) &&
+                     (distances[dst] == std::numeric_limits<int>::max() ||
+                      acyclic_table.Distance(src, dst) == distances[dst]);
+            }
+          }
+          REQUIRE(same);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Test thread pool") {
+  GIVEN("a pool of four threads") {
+    gdwg::ThreadPool pool{4};
+    REQUIRE(pool.ThreadCount() == 4);
+    WHEN("running a parallel loop") {
+      vector<int> hits(10000, 0);
+      std::atomic<bool> thread_in_range{true};
+      pool.ParallelFor(hits.size(), 64, [&](std::size_t begin, std::size_t end,
+                                            std::size_t thread) {
+        thread_in_range = thread_in_range && thread < 4;
+        for (std::size_t i = begin; i < end; ++i) {
+          ++hits[i];
+        }
+      });
+      THEN("every index is visited once, by one of the threads") {
+        REQUIRE(std::all_of(hits.begin(), hits.end(), [](int hit) { return hit == 1; }));
+        REQUIRE(thread_in_range);
+      }
+    }
+    WHEN("a chunk throws") {
+      THEN("the exception is rethrown by the caller, and the pool can be used again") {
+        REQUIRE_THROWS_WITH(pool.ParallelFor(1000, 1,
+                                             [](std::size_t begin, std::size_t, std::size_t) {
+                                               if (begin == 500) {
+                                                 throw std::runtime_error("chunk 500");
+                                               }
+                                             }),
+                            "chunk 500");
+        std::atomic<std::size_t> total{0};
+        pool.ParallelFor(1000, 10, [&total](std::size_t begin, std::size_t end, std::size_t) {
+          total += end - begin;
+        });
+        REQUIRE(total == 1000);
+      }
+    }
+  }
+}
+
+SCENARIO("Test breadth first search") {
+  GIVEN("a graph with a cycle and an unreachable node") {
+    Graph<string, int> g{"a", "b", "c", "d", "e"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("b", "c", 1);
+    g.InsertEdge("c", "a", 1);
+    g.InsertEdge("a", "d", 9);
+    g.InsertEdge("d", "c", 1);
+    WHEN("searching from a") {
+      auto tree = g.BreadthFirstSearch("a");
+      THEN("depths count edges, not weights") {
+        REQUIRE(tree.Source() == "a");
+        REQUIRE(tree.Depth("a") == 0);
+        REQUIRE(tree.Depth("d") == 1);
+        REQUIRE(tree.Depth("c") == 2);
+        REQUIRE_FALSE(tree.IsReachable("e"));
+        REQUIRE(tree.Path("e").empty());
+        REQUIRE(tree.Path("b").size() == 2);
+        REQUIRE(tree.Depths()[tree.Snapshot().Id("e")] == Graph<string, int>::no_node);
+        REQUIRE(tree.Parents()[tree.Snapshot().Id("a")] == tree.Snapshot().Id("a"));
+        REQUIRE_THROWS_WITH(tree.Depth("e"),
+                            "Cannot call Graph::bfs_tree::Depth if dst is unreachable");
+      }
+    }
+    WHEN("searching from a node not in the graph, exception is thrown") {
+      REQUIRE_THROWS_WITH(
+          g.BreadthFirstSearch("f"),
+          "Cannot call Graph::BreadthFirstSearch if src doesn't exist in the graph");
+    }
+  }
+
+  GIVEN("a dense pseudo random graph, where levels are expanded bottom-up") {
+    auto g = RandomGraph(300, 3000, [](unsigned) { return 1; });
+
+    // depths of a plain queue based search
+    vector<std::size_t> expected(300, 300);
+    vector<int> queue{0};
+    expected[0] = 0;
+    for (std::size_t i = 0; i < queue.size(); ++i) {
+      for (int dst : g.GetConnected(queue[i])) {
+        if (expected[dst] == 300) {
+          expected[dst] = expected[queue[i]] + 1;
+          queue.push_back(dst);
+        }
+      }
+    }
+
+    for (std::size_t threads : {1, 4}) {
+      WHEN("searching on " + std::to_string(threads) + " threads") {
+        auto tree = g.BreadthFirstSearch(0, threads);
+        THEN("depths match a queue based search, and every parent is one level up") {
+          bool same = true;
+          for (int node = 0; node < 300; ++node) {
+            if (expected[node] == 300) {
+              same = same && !tree.IsReachable(node);
+            } else if (node != 0) {
+              auto path = tree.Path(node);
+              same = same && tree.Depth(node) == expected[node] &&
+                     path.size() == expected[node] + 1 &&
+                     g.IsConnected(path[path.size() - 2], node);
+            }
+          }
+          REQUIRE(same);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Test lazy traversals") {
+  GIVEN("a graph with a diamond, a parallel edge, a cycle back and an unreachable node") {
+    Graph<string, int> g{"a", "b", "c", "d", "e", "f"};
+    g.InsertEdge("a", "c", 1);
+    g.InsertEdge("a", "b", 5);
+    g.InsertEdge("a", "b", 2);
+    g.InsertEdge("b", "d", 1);
+    g.InsertEdge("c", "d", 1);
+    g.InsertEdge("d", "a", 1);
+    g.InsertEdge("d", "e", 1);
+    g.InsertEdge("f", "a", 1);
+    auto walk = [](auto traversal) {
+      vector<std::tuple<string, std::size_t>> steps;
+      for (auto it = traversal.begin(); it != traversal.end(); ++it) {
+        steps.emplace_back(*it, it.Depth());
+      }
+      return steps;
+    };
+    WHEN("traversing breadth first") {
+      THEN("nodes are yielded once each, in order of depth") {
+        REQUIRE(walk(g.Bfs("a")) == vector<std::tuple<string, std::size_t>>{
+                                        {"a", 0}, {"b", 1}, {"c", 1}, {"d", 2}, {"e", 3}});
+      }
+    }
+    WHEN("traversing depth first") {
+      THEN("nodes are yielded once each, in preorder") {
+        REQUIRE(walk(g.Dfs("a")) == vector<std::tuple<string, std::size_t>>{
+                                        {"a", 0}, {"b", 1}, {"d", 2}, {"e", 3}, {"c", 1}});
+      }
+    }
+    WHEN("stopping at a target") {
+      auto bfs = g.Bfs("a");
+      auto it = std::find(bfs.begin(), bfs.end(), "d");
+      THEN("the edge it was reached by is known, and the traversal can resume") {
+        REQUIRE(it.Depth() == 2);
+        REQUIRE(it.Edge() == std::make_tuple(string{"b"}, string{"d"}, 1));
+        ++it;
+        REQUIRE(*it == "e");
+        REQUIRE(it->size() == 1);
+        ++it;
+        REQUIRE(it == bfs.end());
+      }
+    }
+    THEN("a node reached by parallel edges is reached by the lightest") {
+      auto dfs = g.Dfs("a");
+      auto it = std::next(dfs.begin());
+      REQUIRE(std::get<2>(it.Edge()) == 2);
+    }
+    THEN("the src has no edge, and a missing src throws") {
+      auto bfs = g.Bfs("e");
+      REQUIRE_THROWS_WITH(bfs.begin().Edge(),
+                          "Cannot call Graph::traversal::Edge on the src of the traversal");
+      REQUIRE(std::next(bfs.begin()) == bfs.end());
+      REQUIRE_THROWS_WITH(g.Bfs("g"), "Cannot call Graph::Bfs if src doesn't exist in the graph");
+      REQUIRE_THROWS_WITH(g.Dfs("g"), "Cannot call Graph::Dfs if src doesn't exist in the graph");
+    }
+  }
+
+  GIVEN("a pseudo random graph with deleted nodes") {
+    auto g = RandomGraph(200, 400, [](unsigned r) { return r % 10; });
+    for (int i = 0; i < 200; i += 7) {
+      g.DeleteNode(i);
+    }
+    g.InsertNode(1000);
+    g.InsertEdge(1, 1000, 1);
+    WHEN("traversing from every node") {
+      THEN("both orders reach the nodes of a breadth first search, by edges from nodes before") {
+        bool same = true;
+        for (int src : g.GetNodes()) {
+          auto tree = g.BreadthFirstSearch(src);
+          for (bool depth_first : {false, true}) {
+            auto traversal = depth_first ? g.Dfs(src) : g.Bfs(src);
+            std::set<int> seen;
+            std::size_t depth = 0;
+            for (auto it = traversal.begin(); it != traversal.end(); ++it) {
+              same = same && seen.insert(*it).second && tree.IsReachable(*it);
+              if (*it != src) {
+                same = same && std::get<1>(it.Edge()) == *it && seen.count(std::get<0>(it.Edge()));
+              }
+              if (!depth_first) {
+                same = same && it.Depth() == tree.Depth(*it) && it.Depth() >= depth;
+                depth = it.Depth();
+              }
+            }
+            for (int dst : g.GetNodes()) {
+              same = same && seen.count(dst) == tree.IsReachable(dst);
+            }
+          }
+        }
+        REQUIRE(same);
+      }
+    }
+  }
+}
+
+SCENARIO("Test strongly connected components and topological order") {
+  GIVEN("a graph of two cycles joined by an edge, and a self loop") {
+    Graph<string, int> g{"a", "b", "c", "d", "e", "f"};
+    g.InsertEdge("d", "e", 1);
+    g.InsertEdge("e", "d", 1);
+    g.InsertEdge("e", "a", 1);
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("b", "c", 1);
+    g.InsertEdge("c", "a", 1);
+    g.InsertEdge("f", "f", 1);
+    WHEN("finding the strongly connected components") {
+      auto sccs = g.StronglyConnectedComponents();
+      THEN("cycles share a label, and labels follow the edges between components") {
+        REQUIRE(sccs.Count() == 3);
+        REQUIRE(sccs.SameComponent("a", "c"));
+        REQUIRE(sccs.SameComponent("d", "e"));
+        REQUIRE_FALSE(sccs.SameComponent("a", "d"));
+        REQUIRE(sccs.Label("d") < sccs.Label("a"));
+        REQUIRE(sccs.Labels().size() == 6);
+        REQUIRE_THROWS_WITH(
+            sccs.Label("g"),
+            "Cannot call Graph::components::Label if node doesn't exist in the graph");
+      }
+    }
+    WHEN("sorting the nodes topologically") {
+      THEN("the cycle is reported") {
+        REQUIRE_THROWS_WITH(g.TopologicalOrder(),
+                            "Cannot call Graph::TopologicalOrder on a graph with a cycle");
+        auto cycle = g.FindCycle();
+        REQUIRE(vector<string>(cycle.begin(), cycle.end()) == vector<string>{"a", "b", "c", "a"});
+      }
+    }
+    WHEN("the cycles are broken") {
+      g.erase("c", "a", 1);
+      g.erase("e", "d", 1);
+      g.DeleteNode("f");
+      THEN("every node comes before the nodes it has edges to") {
+        REQUIRE(g.FindCycle().empty());
+        auto order = g.TopologicalOrder();
+        REQUIRE(vector<string>(order.begin(), order.end()) ==
+                vector<string>{"d", "e", "a", "b", "c"});
+        REQUIRE(g.StronglyConnectedComponents().Count() == 5);
+      }
+    }
+  }
+
+  GIVEN("a path too long for a recursive search, closed into a cycle") {
+    const int length = 300000;
+    vector<tuple<int, int, int>> edges;
+    for (int i = 0; i < length; ++i) {
+      edges.emplace_back(i, (i + 1) % length, 1);
+    }
+    Graph<int, int> g{edges.begin(), edges.end()};
+    THEN("the whole path is one component, and the cycle is found") {
+      REQUIRE(g.StronglyConnectedComponents().Count() == 1);
+      REQUIRE(g.FindCycle().size() == length + 1);
+      g.erase(length - 1, 0, 1);
+      REQUIRE(g.StronglyConnectedComponents().Count() == length);
+      REQUIRE(g.TopologicalOrder().back().get() == length - 1);
+    }
+  }
+}
+
+SCENARIO("Test reachability queries") {
+  GIVEN("a cycle feeding a chain, a parallel edge and an isolated node") {
+    Graph<string, int> g{"a", "b", "c", "d", "e", "f"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("b", "a", 1);
+    g.InsertEdge("b", "c", 1);
+    g.InsertEdge("b", "c", 2);
+    g.InsertEdge("c", "d", 1);
+    g.InsertEdge("e", "d", 1);
+    THEN("paths follow edge directions, and every node reaches itself") {
+      REQUIRE(g.IsReachable("a", "d"));
+      REQUIRE(g.IsReachable("b", "a"));
+      REQUIRE_FALSE(g.IsReachable("d", "a"));
+      REQUIRE_FALSE(g.IsReachable("e", "c"));
+      REQUIRE(g.IsReachable("f", "f"));
+      REQUIRE_FALSE(g.IsReachable("a", "f"));
+      REQUIRE_THROWS_WITH(
+          g.IsReachable("a", "g"),
+          "Cannot call Graph::IsReachable if src or dst node don't exist in the graph");
+    }
+    WHEN("the graph changes after a query") {
+      REQUIRE_FALSE(g.IsReachable("d", "a"));
+      THEN("every kind of change is seen by the next query") {
+        g.InsertNode("g");
+        REQUIRE_FALSE(g.IsReachable("a", "g"));
+        g.InsertEdge("d", "g", 1);
+        REQUIRE(g.IsReachable("a", "g"));
+        g.InsertEdge("a", "c", 1);
+        g.erase("b", "c", 2);
+        REQUIRE(g.IsReachable("b", "d"));
+        g.erase("b", "c", 1);
+        REQUIRE(g.IsReachable("b", "d"));
+        g.erase(g.find("a", "c", 1));
+        REQUIRE_FALSE(g.IsReachable("b", "d"));
+        g.InsertEdge("d", "e", 1);
+        g.InsertEdge("e", "a", 1);
+        REQUIRE(g.IsReachable("d", "b"));
+        g.DeleteNode("e");
+        REQUIRE_FALSE(g.IsReachable("d", "b"));
+        g.MergeReplace("g", "b");
+        REQUIRE(g.IsReachable("d", "a"));
+        g.Replace("d", "h");
+        REQUIRE_FALSE(g.IsReachable("c", "h"));
+        REQUIRE_FALSE(g.IsReachable("c", "a"));
+      }
+    }
+  }
+
+  GIVEN("pseudo random graphs, one with cycles and one without") {
+    const int count = 300;
+    Lcg next;
+    auto g = RandomGraph(count, 360, [](unsigned) { return 1; }, next);
+    Graph<int, int> acyclic;
+    for (int i = 0; i < count; ++i) {
+      acyclic.InsertNode(i);
+    }
+    for (int i = 0; i < 360; ++i) {
+      int a = next() % count;
+      int b = next() % count;
+      acyclic.InsertEdge(std::min(a, b), std::max(a, b), 1);
+      acyclic.InsertEdge(std::min(a, b), std::max(a, b), 2);
+    }
+
+    // every pair against a breadth first search from every src
+    auto matches_search = [count](const Graph<int, int>& graph) {
+      for (int src = 0; src < count; ++src) {
+        auto tree = graph.BreadthFirstSearch(src);
+        for (int dst = 0; dst < count; ++dst) {
+          if (graph.IsReachable(src, dst) != tree.IsReachable(dst)) {
+            return false;
+          }
+        }
+      }
+      return true;
+    };
+    WHEN("querying every pair") {
+      THEN("the answers match a search") {
+        REQUIRE(matches_search(g));
+        REQUIRE(matches_search(acyclic));
+      }
+    }
+    WHEN("edges are inserted and erased between queries") {
+      THEN("the answers still match a search") {
+        for (int round = 0; round < 5; ++round) {
+          REQUIRE(matches_search(acyclic));
+          int a = next() % count;
+          int b = next() % count;
+          acyclic.InsertEdge(std::min(a, b), std::max(a, b), 3);
+          acyclic.erase(acyclic.begin());
+          acyclic.erase(std::prev(acyclic.end()));
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Test weakly connected components") {
+  GIVEN("a graph of three islands, one of them held together by edges in both directions") {
+    Graph<string, int> g{"a", "b", "c", "d", "e", "f", "g"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("c", "b", 1);
+    g.InsertEdge("d", "c", 1);
+    g.InsertEdge("e", "f", 1);
+    g.InsertEdge("f", "f", 1);
+    WHEN("finding the weakly connected components") {
+      auto wccs = g.WeaklyConnectedComponents();
+      THEN("edge directions are ignored, and labels follow the smallest node of each island") {
+        REQUIRE(wccs.Count() == 3);
+        REQUIRE(wccs.Label("a") == 0);
+        REQUIRE(wccs.Label("d") == 0);
+        REQUIRE(wccs.Label("f") == 1);
+        REQUIRE(wccs.Label("g") == 2);
+        REQUIRE(g.StronglyConnectedComponents().Count() == 7);
+      }
+    }
+  }
+
+  GIVEN("a sparse pseudo random graph with many components") {
+    auto g = RandomGraph(2000, 1500, [](unsigned) { return 1; });
+
+    // components of a breadth first search over edges in both directions
+    vector<std::size_t> expected(2000, 2000);
+    std::size_t islands = 0;
+    for (int root = 0; root < 2000; ++root) {
+      if (expected[root] != 2000) {
+        continue;
+      }
+      vector<int> queue{root};
+      expected[root] = islands;
+      for (std::size_t i = 0; i < queue.size(); ++i) {
+        auto neighbours = g.GetConnected(queue[i]);
+        auto incoming = g.GetIncoming(queue[i]);
+        neighbours.insert(neighbours.end(), incoming.begin(), incoming.end());
+        for (int node : neighbours) {
+          if (expected[node] == 2000) {
+            expected[node] = islands;
+            queue.push_back(node);
+          }
+        }
+      }
+      ++islands;
+    }
+
+    for (std::size_t threads : {1, 4}) {
+      WHEN("finding the components on " + std::to_string(threads) + " threads") {
+        auto wccs = g.WeaklyConnectedComponents(threads);
+        THEN("they match a search over both directions") {
+          REQUIRE(wccs.Count() == islands);
+          bool same = true;
+          for (int node = 0; node < 2000; ++node) {
+            same = same && wccs.Label(node) == expected[node];
+          }
+          REQUIRE(same);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Test PageRank and sparse matrix-vector products") {
+  GIVEN("a graph with weighted edges and a node without out-edges") {
+    Graph<string, double> g{"a", "b", "c", "d"};
+    g.InsertEdge("a", "b", 3);
+    g.InsertEdge("a", "c", 1);
+    g.InsertEdge("b", "c", 1);
+    g.InsertEdge("c", "a", 1);
+    g.InsertEdge("c", "a", 2);
+    WHEN("multiplying the snapshot by a vector") {
+      auto y = g.Freeze().Multiply(vector<double>{1, 10, 100, 1000});
+      THEN("each node sums the weighted values of its srcs") {
+        REQUIRE(y == vector<double>{300, 3, 11, 0});
+        REQUIRE_THROWS_WITH(
+            g.Freeze().Multiply(vector<double>{1}),
+            "Cannot call Graph::snapshot::Multiply with a vector not of one value per node");
+      }
+    }
+    WHEN("ranking the nodes") {
+      auto ranks = g.PageRank(0.85, 1e-12, 1000, 4);
+      THEN("ranks converge, sum to one, and follow the weights") {
+        REQUIRE(ranks.Converged());
+        REQUIRE(ranks.Iterations() > 1);
+        double total = 0;
+        for (double rank : ranks.Ranks()) {
+          total += rank;
+        }
+        REQUIRE(total == Approx(1));
+        REQUIRE(ranks.Rank("b") > ranks.Rank("d"));
+        REQUIRE(ranks.Rank("c") > ranks.Rank("b"));
+        // d only gets the share every node gets, from d itself and from damping
+        REQUIRE(ranks.Rank("d") == Approx((0.15 + 0.85 * ranks.Rank("d")) / 4));
+        REQUIRE(ranks.Rank("b") == Approx(ranks.Rank("d") + 0.85 * 0.75 * ranks.Rank("a")));
+      }
+    }
+    WHEN("the iterations are capped") {
+      auto ranks = g.PageRank(0.85, 0, 3);
+      THEN("the ranks are returned unconverged") {
+        REQUIRE(ranks.Iterations() == 3);
+        REQUIRE_FALSE(ranks.Converged());
+      }
+    }
+    WHEN("the damping is out of range, exception is thrown") {
+      REQUIRE_THROWS_WITH(g.PageRank(1.5),
+                          "Cannot call Graph::PageRank with a damping outside [0, 1]");
+    }
+  }
+
+  GIVEN("a cycle") {
+    Graph<int, int> g{1, 2, 3, 4};
+    g.InsertEdge(1, 2, 5);
+    g.InsertEdge(2, 3, 1);
+    g.InsertEdge(3, 4, 2);
+    g.InsertEdge(4, 1, 7);
+    THEN("every node ranks the same, whatever the weights") {
+      auto ranks = g.PageRank();
+      REQUIRE(ranks.Rank(1) == Approx(0.25));
+      REQUIRE(ranks.Rank(3) == Approx(0.25));
+    }
+  }
+}
+
+SCENARIO("Test triangles and clustering coefficients") {
+  GIVEN("two triangles sharing an edge, with a parallel edge, a reversed edge and a self loop") {
+    Graph<string, int> g{"a", "b", "c", "d", "e"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("a", "b", 2);
+    g.InsertEdge("b", "a", 1);
+    g.InsertEdge("b", "c", 1);
+    g.InsertEdge("c", "a", 1);
+    g.InsertEdge("d", "b", 1);
+    g.InsertEdge("c", "d", 1);
+    g.InsertEdge("c", "c", 1);
+    g.InsertEdge("d", "e", 1);
+    WHEN("counting triangles") {
+      THEN("edge directions, repeats and loops are ignored") {
+        REQUIRE(g.CountTriangles() == 2);
+      }
+    }
+    WHEN("computing clustering coefficients") {
+      auto clusters = g.ClusteringCoefficients();
+      THEN("each node counts the triangles through it over its pairs of neighbours") {
+        REQUIRE(clusters.Triangles("b") == 2);
+        REQUIRE(clusters.Triangles("a") == 1);
+        REQUIRE(clusters.Triangles("e") == 0);
+        REQUIRE(clusters.Coefficient("a") == Approx(1));
+        REQUIRE(clusters.Coefficient("b") == Approx(2.0 / 3));
+        REQUIRE(clusters.Coefficient("d") == Approx(1.0 / 3));
+        REQUIRE(clusters.Coefficient("e") == 0);
+        REQUIRE(clusters.AverageCoefficient() == Approx((1 + 2.0 / 3 + 2.0 / 3 + 1.0 / 3) / 5));
+        REQUIRE_THROWS_WITH(
+            clusters.Coefficient("f"),
+            "Cannot call Graph::clustering::Coefficient if node doesn't exist in the graph");
+      }
+    }
+  }
+
+  GIVEN("sorted lists of very different lengths") {
+    vector<int> evens;
+    for (int i = 0; i < 1000; ++i) {
+      evens.push_back(2 * i);
+    }
+    vector<int> few{-1, 4, 5, 998, 1998, 2000};
+    THEN("the short list is searched in the long one, with the same result as a merge") {
+      REQUIRE(gdwg::IntersectionSize(few.begin(), few.end(), evens.begin(), evens.end()) == 3);
+      REQUIRE(gdwg::IntersectionSize(evens.begin(), evens.end(), few.begin(), few.end()) == 3);
+      REQUIRE(gdwg::IntersectionSize(evens.begin(), evens.begin() + 100, few.begin(),
+                                     few.end()) == 1);
+    }
+  }
+
+  GIVEN("a dense pseudo random graph") {
+    auto g = RandomGraph(60, 600, [](unsigned) { return 1; });
+
+    // every triple of distinct nodes, checked in both directions
+    auto adjacent = [&g](int a, int b) { return g.IsConnected(a, b) || g.IsConnected(b, a); };
+    std::size_t expected = 0;
+    vector<std::size_t> through(60, 0);
+    for (int a = 0; a < 60; ++a) {
+      for (int b = a + 1; b < 60; ++b) {
+        for (int c = b + 1; c < 60; ++c) {
+          if (adjacent(a, b) && adjacent(b, c) && adjacent(a, c)) {
+            ++expected;
+            ++through[a];
+            ++through[b];
+            ++through[c];
+          }
+        }
+      }
+    }
+
+    for (std::size_t threads : {1, 4}) {
+      WHEN("counting on " + std::to_string(threads) + " threads") {
+        auto clusters = g.ClusteringCoefficients(threads);
+        THEN("the counts match a check of every triple") {
+          REQUIRE(g.CountTriangles(threads) == expected);
+          REQUIRE(clusters.TriangleCounts() == through);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Test betweenness centrality") {
+  GIVEN("a diamond with a heavy side, a tail, a parallel edge and a self loop") {
+    Graph<string, int> g{"a", "b", "c", "d", "e", "f"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("a", "b", 3);
+    g.InsertEdge("a", "c", 1);
+    g.InsertEdge("b", "d", 1);
+    g.InsertEdge("c", "d", 5);
+    g.InsertEdge("c", "c", 1);
+    g.InsertEdge("d", "e", 1);
+    WHEN("counting edges") {
+      auto centrality = g.Betweenness();
+      THEN("paths split evenly over both sides, and repeats and loops don't count") {
+        REQUIRE(centrality.Score("a") == 0);
+        REQUIRE(centrality.Score("b") == Approx(1));
+        REQUIRE(centrality.Score("c") == Approx(1));
+        REQUIRE(centrality.Score("d") == Approx(3));
+        REQUIRE(centrality.Score("e") == 0);
+        REQUIRE(centrality.Score("f") == 0);
+        REQUIRE_THROWS_WITH(
+            centrality.Score("g"),
+            "Cannot call Graph::centrality::Score if node doesn't exist in the graph");
+      }
+    }
+    WHEN("adding weights") {
+      auto centrality = g.Betweenness(true);
+      THEN("only the light side is on shortest paths") {
+        REQUIRE(centrality.Score("b") == Approx(2));
+        REQUIRE(centrality.Score("c") == 0);
+        REQUIRE(centrality.Score("d") == Approx(3));
+      }
+    }
+    WHEN("a weight is negative") {
+      g.InsertEdge("e", "a", -1);
+      THEN("the weighted search throws") {
+        REQUIRE_THROWS_WITH(g.Betweenness(true),
+                            "Cannot call Graph::Betweenness on negative weights");
+        REQUIRE_NOTHROW(g.Betweenness());
+      }
+    }
+  }
+
+  GIVEN("a pseudo random graph") {
+    const int count = 40;
+    auto g = RandomGraph(count, 120, [](unsigned r) { return 1 + r % 4; });
+
+    // distances and path counts between every pair, then every pair checked through every node
+    auto reference = [&g, count](bool weighted) {
+      const int infinity = std::numeric_limits<int>::max() / 4;
+      vector<vector<int>> lengths(count, vector<int>(count, infinity));
+      for (const auto& [src, dst, weight] : g) {
+        if (src != dst) {
+          lengths[src][dst] = std::min(lengths[src][dst], weighted ? weight : 1);
+        }
+      }
+      vector<vector<int>> distances = lengths;
+      for (int i = 0; i < count; ++i) {
+        distances[i][i] = 0;
+      }
+      for (int k = 0; k < count; ++k) {
+        for (int i = 0; i < count; ++i) {
+          for (int j = 0; j < count; ++j) {
+            distances[i][j] = std::min(distances[i][j], distances[i][k] + distances[k][j]);
+          }
+        }
+      }
+      vector<vector<double>> paths(count, vector<double>(count, 0));
+      for (int src = 0; src < count; ++src) {
+        vector<int> order(count);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(),
+                  [&](int a, int b) { return distances[src][a] < distances[src][b]; });
+        paths[src][src] = 1;
+        for (int dst : order) {
+          for (int via = 0; via < count; ++via) {
+            if (dst != src && lengths[via][dst] < infinity &&
+                distances[src][via] + lengths[via][dst] == distances[src][dst]) {
+              paths[src][dst] += paths[src][via];
+            }
+          }
+        }
+      }
+      vector<double> scores(count, 0);
+      for (int src = 0; src < count; ++src) {
+        for (int dst = 0; dst < count; ++dst) {
+          for (int via = 0; via < count; ++via) {
+            if (src != dst && via != src && via != dst && distances[src][dst] < infinity &&
+                distances[src][via] + distances[via][dst] == distances[src][dst]) {
+              scores[via] += paths[src][via] * paths[via][dst] / paths[src][dst];
+            }
+          }
+        }
+      }
+      return scores;
+    };
+
+    for (std::size_t threads : {1, 4}) {
+      WHEN("computing scores on " + std::to_string(threads) + " threads") {
+        for (bool weighted : {false, true}) {
+          auto centrality = g.Betweenness(weighted, 0, threads);
+          auto expected = reference(weighted);
+          THEN("the scores match a check of every pair of nodes") {
+            for (int node = 0; node < count; ++node) {
+              REQUIRE(centrality.Score(node) == Approx(expected[node]));
+            }
+          }
+        }
+      }
+      WHEN("sampling srcs on " + std::to_string(threads) + " threads") {
+        auto sampled = g.Betweenness(false, 10, threads);
+        THEN("the same srcs are sampled every time, and sampling every node is exact") {
+          auto again = g.Betweenness(false, 10, 1);
+          auto every = g.Betweenness(false, count, threads);
+          auto exact = g.Betweenness(false, 0, 1);
+          for (int node = 0; node < count; ++node) {
+            REQUIRE(sampled.Score(node) == Approx(again.Score(node)));
+            REQUIRE(every.Score(node) == Approx(exact.Score(node)));
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Test maximum flow and minimum cut") {
+  GIVEN("the textbook network, with a split edge, a self loop and an edge back to the source") {
+    Graph<string, int> g{"s", "v1", "v2", "v3", "v4", "t", "x"};
+    g.InsertEdge("s", "v1", 10);
+    g.InsertEdge("s", "v1", 6);
+    g.InsertEdge("s", "v2", 13);
+    g.InsertEdge("v1", "v3", 12);
+    g.InsertEdge("v2", "v1", 4);
+    g.InsertEdge("v2", "v4", 14);
+    g.InsertEdge("v3", "v2", 9);
+    g.InsertEdge("v3", "t", 20);
+    g.InsertEdge("v4", "v3", 7);
+    g.InsertEdge("v4", "t", 4);
+    g.InsertEdge("v1", "v1", 100);
+    g.InsertEdge("t", "s", 5);
+    WHEN("pushing flow from s to t") {
+      auto flow = g.MaxFlow("s", "t");
+      THEN("the parallel edges add up, and the cut edges weigh as much as the flow") {
+        REQUIRE(flow.Value() == 23);
+        vector<string> side;
+        for (const auto& node : g.GetNodes()) {
+          if (flow.IsSourceSide(node)) {
+            side.push_back(node);
+          }
+        }
+        REQUIRE(side == vector<string>{"s", "v1", "v2", "v4"});
+        vector<std::tuple<string, string, int>> cut;
+        for (const auto& edge : flow.CutEdges()) {
+          cut.push_back(*edge);
+        }
+        REQUIRE(cut == vector<std::tuple<string, string, int>>{
+                           {"v1", "v3", 12}, {"v4", "t", 4}, {"v4", "v3", 7}});
+      }
+    }
+    WHEN("the sink can't be reached") {
+      auto flow = g.MaxFlow("s", "x");
+      THEN("there is no flow and no cut edge") {
+        REQUIRE(flow.Value() == 0);
+        REQUIRE(flow.CutEdges().empty());
+        REQUIRE(flow.IsSourceSide("t"));
+        REQUIRE_FALSE(flow.IsSourceSide("x"));
+      }
+    }
+    THEN("bad ends and negative capacities throw") {
+      REQUIRE_THROWS_WITH(
+          g.MaxFlow("s", "y"),
+          "Cannot call Graph::MaxFlow if source or sink node don't exist in the graph");
+      REQUIRE_THROWS_WITH(g.MaxFlow("s", "s"),
+                          "Cannot call Graph::MaxFlow if source and sink are the same node");
+      g.InsertEdge("x", "t", -1);
+      REQUIRE_THROWS_WITH(g.MaxFlow("s", "t"),
+                          "Cannot call Graph::MaxFlow on negative capacities");
+    }
+  }
+
+  GIVEN("a pseudo random graph with fractional capacities") {
+    const int count = 40;
+    Lcg next;
+    auto g = RandomGraph<double>(count, 200, [](unsigned r) { return (r % 40) / 4.0; }, next);
+
+    // augmenting shortest paths on a dense matrix of summed capacities
+    auto reference = [&g, count](int src, int dst) {
+      vector<vector<double>> capacities(count, vector<double>(count, 0));
+      for (const auto& [from, to, weight] : g) {
+        if (from != to) {
+          capacities[from][to] += weight;
+        }
+      }
+      double total = 0;
+      while (true) {
+        vector<int> parents(count, -1);
+        parents[src] = src;
+        vector<int> queue{src};
+        for (std::size_t i = 0; i < queue.size() && parents[dst] == -1; ++i) {
+          for (int to = 0; to < count; ++to) {
+            if (parents[to] == -1 && capacities[queue[i]][to] > 0) {
+              parents[to] = queue[i];
+              queue.push_back(to);
+            }
+          }
+        }
+        if (parents[dst] == -1) {
+          return total;
+        }
+        double bottleneck = std::numeric_limits<double>::max();
+        for (int node = dst; node != src; node = parents[node]) {
+          bottleneck = std::min(bottleneck, capacities[parents[node]][node]);
+        }
+        for (int node = dst; node != src; node = parents[node]) {
+          capacities[parents[node]][node] -= bottleneck;
+          capacities[node][parents[node]] += bottleneck;
+        }
+        total += bottleneck;
+      }
+    };
+
+    WHEN("pushing flow between several pairs of nodes") {
+      THEN("the values match the reference, and the cut edges weigh as much") {
+        for (int i = 0; i < 10; ++i) {
+          int src = next() % count;
+          int dst = (src + 1 + next() % (count - 1)) % count;
+          auto flow = g.MaxFlow(src, dst);
+          REQUIRE(flow.Value() == Approx(reference(src, dst)));
+          REQUIRE(flow.IsSourceSide(src));
+          REQUIRE_FALSE(flow.IsSourceSide(dst));
+          double cut = 0;
+          for (const auto& edge : flow.CutEdges()) {
+            cut += std::get<2>(*edge);
+          }
+          REQUIRE(cut == Approx(flow.Value()));
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Test minimum spanning forest") {
+  GIVEN("two trees, with edges both ways, a parallel edge and a self loop") {
+    Graph<string, int> g{"a", "b", "c", "d", "e", "f", "g"};
+    g.InsertEdge("a", "b", 4);
+    g.InsertEdge("b", "c", 1);
+    g.InsertEdge("c", "a", 2);
+    g.InsertEdge("c", "d", 5);
+    g.InsertEdge("c", "d", 8);
+    g.InsertEdge("b", "d", 7);
+    g.InsertEdge("d", "d", 0);
+    g.InsertEdge("e", "f", 3);
+    g.InsertEdge("f", "e", 3);
+    WHEN("finding the forest") {
+      auto forest = g.MinimumSpanningForest();
+      THEN("the lightest edges joining trees are returned as iterators, lightest first") {
+        vector<std::tuple<string, string, int>> edges;
+        for (const auto& it : forest) {
+          edges.push_back(*it);
+        }
+        REQUIRE(edges == vector<std::tuple<string, string, int>>{
+                             {"b", "c", 1}, {"c", "a", 2}, {"e", "f", 3}, {"c", "d", 5}});
+        REQUIRE(forest[0] == g.find("b", "c", 1));
+      }
+    }
+    WHEN("an edge is erased through the forest") {
+      g.erase(g.MinimumSpanningForest()[1]);
+      THEN("the forest goes around it") {
+        REQUIRE(*g.MinimumSpanningForest()[2] == std::tuple<string, string, int>{"a", "b", 4});
+      }
+    }
+  }
+
+  GIVEN("a pseudo random graph with more edges than a sorted run") {
+    const int count = 300;
+    auto g = RandomGraph(count, 10000, [](unsigned r) { return r % 100; });
+    for (int i = count; i < count + 5; ++i) {
+      g.InsertNode(i);
+    }
+    g.InsertEdge(count, count + 1, 5);
+
+    // Prim's algorithm from every node not yet in a tree, on a dense matrix of undirected weights
+    const int none = std::numeric_limits<int>::max();
+    vector<vector<int>> lightest(count + 5, vector<int>(count + 5, none));
+    for (const auto& [src, dst, weight] : g) {
+      if (src != dst) {
+        lightest[src][dst] = std::min(lightest[src][dst], weight);
+        lightest[dst][src] = std::min(lightest[dst][src], weight);
+      }
+    }
+    long expected = 0;
+    vector<bool> in_tree(count + 5, false);
+    vector<int> costs(count + 5, none);
+    for (int start = 0; start < count + 5; ++start) {
+      if (in_tree[start]) {
+        continue;
+      }
+      costs[start] = 0;
+      while (true) {
+        int best = -1;
+        for (int node = 0; node < count + 5; ++node) {
+          if (!in_tree[node] && costs[node] != none && (best == -1 || costs[node] < costs[best])) {
+            best = node;
+          }
+        }
+        if (best == -1) {
+          break;
+        }
+        in_tree[best] = true;
+        expected += costs[best];
+        for (int node = 0; node < count + 5; ++node) {
+          costs[node] = std::min(costs[node], lightest[best][node]);
+        }
+      }
+    }
+
+    for (std::size_t threads : {1, 4}) {
+      WHEN("finding the forest on " + std::to_string(threads) + " threads") {
+        auto forest = g.MinimumSpanningForest(threads);
+        THEN("it spans every component and weighs as much as Prim's") {
+          REQUIRE(forest.size() == count + 5 - g.WeaklyConnectedComponents().Count());
+          long total = 0;
+          for (const auto& it : forest) {
+            total += std::get<2>(*it);
+          }
+          REQUIRE(total == expected);
+          REQUIRE(std::is_sorted(forest.begin(), forest.end(), [](const auto& a, const auto& b) {
+            return std::get<2>(*a) < std::get<2>(*b);
+          }));
+          REQUIRE(forest == g.MinimumSpanningForest(1));
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Test k-core decomposition and degrees") {
+  GIVEN("a four clique with a tail, a parallel edge and a self loop") {
+    Graph<string, int> g{"a", "b", "c", "d", "e", "f", "g"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("a", "c", 1);
+    g.InsertEdge("a", "d", 1);
+    g.InsertEdge("b", "c", 1);
+    g.InsertEdge("d", "b", 1);
+    g.InsertEdge("c", "d", 1);
+    g.InsertEdge("c", "d", 2);
+    g.InsertEdge("d", "e", 1);
+    g.InsertEdge("e", "f", 1);
+    g.InsertEdge("f", "f", 1);
+    WHEN("decomposing the graph into cores") {
+      auto cores = g.CoreDecomposition();
+      THEN("the clique is the 3-core, and the tail peels off") {
+        REQUIRE(cores.Degeneracy() == 3);
+        REQUIRE(cores.CoreNumber("a") == 3);
+        REQUIRE(cores.CoreNumber("e") == 1);
+        REQUIRE(cores.CoreNumber("f") == 1);
+        REQUIRE(cores.CoreNumber("g") == 0);
+        auto core = cores.Core(2);
+        REQUIRE(vector<string>(core.begin(), core.end()) == vector<string>{"a", "b", "c", "d"});
+        REQUIRE(cores.Core(4).empty());
+        REQUIRE(cores.CoreNumbers().size() == 7);
+      }
+    }
+    WHEN("getting degrees from a snapshot") {
+      auto frozen = g.Freeze();
+      THEN("parallel edges and loops count, and histograms count nodes by degree") {
+        REQUIRE(frozen.OutDegrees() == vector<std::size_t>{3, 1, 2, 2, 1, 1, 0});
+        REQUIRE(frozen.InDegrees() == vector<std::size_t>{0, 2, 2, 3, 1, 2, 0});
+        REQUIRE(frozen.OutDegree(frozen.Id("c")) == 2);
+        REQUIRE(frozen.InDegree(frozen.Id("d")) == 3);
+        REQUIRE(frozen.OutDegreeHistogram() == vector<std::size_t>{1, 3, 2, 1});
+        REQUIRE(frozen.InDegreeHistogram() == vector<std::size_t>{2, 1, 3, 1});
+      }
+    }
+  }
+
+  GIVEN("a pseudo random graph") {
+    auto g = RandomGraph(200, 1200, [](unsigned) { return 1; });
+    THEN("every node is in the core a repeated peel of each k leaves it in") {
+      auto cores = g.CoreDecomposition();
+      vector<std::set<int>> neighbours(200);
+      for (const auto& [src, dst, w] : g) {
+        if (src != dst && w == 1) {
+          neighbours[src].insert(dst);
+          neighbours[dst].insert(src);
+        }
+      }
+      bool same = true;
+      for (std::size_t k = 0; k <= cores.Degeneracy() + 1; ++k) {
+        vector<bool> alive(200, true);
+        for (bool peeled = true; peeled;) {
+          peeled = false;
+          for (int node = 0; node < 200; ++node) {
+            std::size_t degree = std::count_if(neighbours[node].begin(), neighbours[node].end(),
+                                               [&alive](int other) { return alive[other]; });
+            if (alive[node] && degree < k) {
+              alive[node] = false;
+              peeled = true;
+            }
+          }
+        }
+        for (int node = 0; node < 200; ++node) {
+          same = same && alive[node] == (cores.CoreNumber(node) >= k);
+        }
+      }
+      REQUIRE(same);
+    }
+  }
+}
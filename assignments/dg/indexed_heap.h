@@ -0,0 +1,135 @@
+#ifndef ASSIGNMENTS_DG_INDEXED_HEAP_H_
+#define ASSIGNMENTS_DG_INDEXED_HEAP_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+
+// indexed 4-ary min-heap of ids below a fixed capacity, each id is in the heap at most once
+// lowering the key of an id already in the heap is O(log n), the priority queue of Dijkstra
+// Clear() only touches the ids in the heap, so one heap can be reused by many searches
+template <typename Key>
+class IndexedHeap {
+ public:
+  using id_type = std::uint32_t;
+
+  IndexedHeap() = default;
+
+  explicit IndexedHeap(std::size_t capacity) : positions_(capacity, npos) {}
+
+  // grow the range of ids, ids already in the heap are kept
+  void Reserve(std::size_t capacity) {
+    if (capacity > positions_.size()) {
+      positions_.resize(capacity, npos);
+    }
+  }
+
+  std::size_t Capacity() const noexcept { return positions_.size(); }
+
+  bool Empty() const noexcept { return heap_.empty(); }
+
+  std::size_t Size() const noexcept { return heap_.size(); }
+
+  bool Contains(id_type id) const noexcept { return positions_[id] != npos; }
+
+  // the id with the smallest key and its key, only valid if not empty
+  id_type TopId() const noexcept { return heap_.front().second; }
+
+  const Key& TopKey() const noexcept { return heap_.front().first; }
+
+  // insert id with key, or lower its key if it is in the heap with a larger key
+  // return if the heap changed
+  bool Push(id_type id, const Key& key) {
+    std::size_t pos = positions_[id];
+    if (pos == npos) {
+      pos = heap_.size();
+      heap_.emplace_back(key, id);
+    } else if (key < heap_[pos].first) {
+      heap_[pos].first = key;
+    } else {
+      return false;
+    }
+    SiftUp(pos);
+    return true;
+  }
+
+  // remove the id with the smallest key
+  void Pop() {
+    positions_[heap_.front().second] = npos;
+    if (heap_.size() > 1) {
+      heap_.front() = std::move(heap_.back());
+      heap_.pop_back();
+      SiftDown(0);
+    } else {
+      heap_.pop_back();
+    }
+  }
+
+  // remove every id, in O(Size())
+  void Clear() noexcept {
+    for (const auto& entry : heap_) {
+      positions_[entry.second] = npos;
+    }
+    heap_.clear();
+  }
+
+ private:
+  static constexpr std::size_t arity = 4;
+  static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  // move the entry at pos towards the root until its parent is not larger
+  void SiftUp(std::size_t pos) {
+    auto entry = std::move(heap_[pos]);
+    while (pos > 0) {
+      std::size_t parent = (pos - 1) / arity;
+      if (!(entry.first < heap_[parent].first)) {
+        break;
+      }
+      Place(pos, std::move(heap_[parent]));
+      pos = parent;
+    }
+    Place(pos, std::move(entry));
+  }
+
+  // move the entry at pos towards the leaves until no child is smaller
+  void SiftDown(std::size_t pos) {
+    auto entry = std::move(heap_[pos]);
+    while (true) {
+      std::size_t first = pos * arity + 1;
+      if (first >= heap_.size()) {
+        break;
+      }
+      std::size_t last = std::min(first + arity, heap_.size());
+      std::size_t smallest = first;
+      for (std::size_t child = first + 1; child < last; ++child) {
+        if (heap_[child].first < heap_[smallest].first) {
+          smallest = child;
+        }
+      }
+      if (!(heap_[smallest].first < entry.first)) {
+        break;
+      }
+      Place(pos, std::move(heap_[smallest]));
+      pos = smallest;
+    }
+    Place(pos, std::move(entry));
+  }
+
+  void Place(std::size_t pos, std::pair<Key, id_type>&& entry) {
+    positions_[entry.second] = pos;
+    heap_[pos] = std::move(entry);
+  }
+
+  // entries of {key, id}, and the position of every id in heap_ or npos
+  std::vector<std::pair<Key, id_type>> heap_;
+  std::vector<std::size_t> positions_;
+};
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_INDEXED_HEAP_H_
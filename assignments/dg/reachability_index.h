@@ -0,0 +1,219 @@
+#ifndef ASSIGNMENTS_DG_REACHABILITY_INDEX_H_
+#define ASSIGNMENTS_DG_REACHABILITY_INDEX_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+
+// reachability index of a directed graph in compressed sparse row form, given its strongly
+// connected components
+// nodes of a component reach each other, so queries run on the condensation, a DAG of the
+// components, where every component gets an interval from each of a few depth first traversals
+// a component only reaches components whose intervals are inside its own, which rules out most
+// unreachable pairs at once, and a component under another in the spanning tree of the first
+// traversal is reached, which confirms many reachable pairs, the rest are searched depth first,
+// skipping components whose intervals rule them out
+class ReachabilityIndex {
+ public:
+  using id_type = std::uint32_t;
+
+  // the out-arcs of node i are at [offsets[i], offsets[i + 1]) of dsts, labels[i] is the
+  // component of node i, from 0 to components - 1, in a topological order of the components
+  ReachabilityIndex(const std::vector<std::size_t>& offsets, const std::vector<id_type>& dsts,
+                    std::vector<id_type> labels, std::size_t components);
+
+  std::size_t NodeCount() const noexcept { return labels_.size(); }
+
+  std::size_t ComponentCount() const noexcept { return offsets_.size() - 1; }
+
+  // if there is a path from src to dst, every node reaches itself
+  bool Reaches(id_type src, id_type dst) const;
+
+ private:
+  // number of depth first traversals labelling the components, each with its own child order
+  static constexpr std::size_t traversals = 2;
+
+  // interval of a component in one traversal, its post order number, and the smallest post order
+  // number of the components it reaches
+  struct interval {
+    id_type low;
+    id_type post;
+  };
+
+  // helper function, if the intervals of from contain those of to, which it must to reach it
+  bool MayReach(id_type from, id_type to) const noexcept {
+    for (std::size_t t = 0; t < traversals; ++t) {
+      const interval& outer = intervals_[t][from];
+      const interval& inner = intervals_[t][to];
+      if (inner.low < outer.low || outer.post < inner.post) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // helper function, if to is under from in the spanning tree of the first traversal
+  bool UnderInTree(id_type from, id_type to) const noexcept {
+    return pres_[from] <= pres_[to] && intervals_[0][to].post <= intervals_[0][from].post;
+  }
+
+  // helper function, number the components in one traversal, children in reverse if reversed
+  void Label(std::size_t t, bool reversed);
+
+  // labels_[i] is the component of node i, the condensation has the arcs of component c at
+  // [offsets_[c], offsets_[c + 1]) of dsts_, sorted without repeats, always to larger components
+  std::vector<id_type> labels_;
+  std::vector<std::size_t> offsets_;
+  std::vector<id_type> dsts_;
+  std::vector<interval> intervals_[traversals];
+  std::vector<id_type> pres_;
+};
+
+inline ReachabilityIndex::ReachabilityIndex(const std::vector<std::size_t>& offsets,
+                                            const std::vector<id_type>& dsts,
+                                            std::vector<id_type> labels, std::size_t components)
+  : labels_{std::move(labels)}, offsets_(components + 1, 0) {
+  // arcs between components, counted, placed, then sorted and deduplicated per component
+  std::size_t count = labels_.size();
+  for (std::size_t from = 0; from < count; ++from) {
+    for (std::size_t edge = offsets[from]; edge < offsets[from + 1]; ++edge) {
+      if (labels_[dsts[edge]] != labels_[from]) {
+        ++offsets_[labels_[from] + 1];
+      }
+    }
+  }
+  for (std::size_t c = 0; c < components; ++c) {
+    offsets_[c + 1] += offsets_[c];
+  }
+  dsts_.resize(offsets_.back());
+  std::vector<std::size_t> next(offsets_.begin(), offsets_.end() - 1);
+  for (std::size_t from = 0; from < count; ++from) {
+    for (std::size_t edge = offsets[from]; edge < offsets[from + 1]; ++edge) {
+      if (labels_[dsts[edge]] != labels_[from]) {
+        dsts_[next[labels_[from]]++] = labels_[dsts[edge]];
+      }
+    }
+  }
+  std::size_t kept = 0;
+  for (std::size_t c = 0; c < components; ++c) {
+    auto first = dsts_.begin() + offsets_[c];
+    auto last = dsts_.begin() + offsets_[c + 1];
+    std::sort(first, last);
+    last = std::unique(first, last);
+    offsets_[c] = kept;
+    for (auto it = first; it != last; ++it) {
+      dsts_[kept++] = *it;
+    }
+  }
+  offsets_[components] = kept;
+  dsts_.resize(kept);
+  dsts_.shrink_to_fit();
+
+  for (std::size_t t = 0; t < traversals; ++t) {
+    Label(t, t % 2 == 1);
+  }
+}
+
+inline void ReachabilityIndex::Label(std::size_t t, bool reversed) {
+  std::size_t components = ComponentCount();
+  auto& intervals = intervals_[t];
+  intervals.assign(components, {0, 0});
+  if (t == 0) {
+    pres_.assign(components, 0);
+  }
+
+  // explicit stack of components with the number of their arcs already followed
+  std::vector<unsigned char> visited(components, 0);
+  std::vector<std::pair<id_type, std::size_t>> stack;
+  id_type pre = 0;
+  id_type post = 0;
+  for (std::size_t i = 0; i < components; ++i) {
+    auto root = static_cast<id_type>(reversed ? components - 1 - i : i);
+    if (visited[root]) {
+      continue;
+    }
+    visited[root] = 1;
+    if (t == 0) {
+      pres_[root] = pre++;
+    }
+    stack.emplace_back(root, 0);
+    while (!stack.empty()) {
+      auto& [c, followed] = stack.back();
+      std::size_t degree = offsets_[c + 1] - offsets_[c];
+      if (followed < degree) {
+        std::size_t arc = reversed ? offsets_[c + 1] - 1 - followed : offsets_[c] + followed;
+        ++followed;
+        id_type child = dsts_[arc];
+        if (!visited[child]) {
+          visited[child] = 1;
+          if (t == 0) {
+            pres_[child] = pre++;
+          }
+          stack.emplace_back(child, 0);
+        }
+        continue;
+      }
+      // every component c reaches has finished, the condensation has no cycles
+      id_type low = ++post;
+      for (std::size_t arc = offsets_[c]; arc < offsets_[c + 1]; ++arc) {
+        low = std::min(low, intervals[dsts_[arc]].low);
+      }
+      intervals[c] = {low, post};
+      stack.pop_back();
+    }
+  }
+}
+
+inline bool ReachabilityIndex::Reaches(id_type src, id_type dst) const {
+  id_type from = labels_[src];
+  id_type to = labels_[dst];
+  if (from == to) {
+    return true;
+  }
+  // arcs only go to larger components
+  if (to < from || !MayReach(from, to)) {
+    return false;
+  }
+  if (UnderInTree(from, to)) {
+    return true;
+  }
+
+  // one scratch per thread, components are marked with the number of the search, so nothing is
+  // cleared between searches
+  thread_local std::vector<std::uint64_t> marks;
+  thread_local std::uint64_t search = 0;
+  thread_local std::vector<id_type> stack;
+  if (marks.size() < ComponentCount()) {
+    marks.resize(ComponentCount(), 0);
+  }
+  ++search;
+  stack.assign(1, from);
+  marks[from] = search;
+  while (!stack.empty()) {
+    id_type c = stack.back();
+    stack.pop_back();
+    for (std::size_t arc = offsets_[c]; arc < offsets_[c + 1]; ++arc) {
+      id_type child = dsts_[arc];
+      if (child == to) {
+        return true;
+      }
+      if (marks[child] == search || to < child || !MayReach(child, to)) {
+        continue;
+      }
+      if (UnderInTree(child, to)) {
+        return true;
+      }
+      marks[child] = search;
+      stack.push_back(child);
+    }
+  }
+  return false;
+}
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_REACHABILITY_INDEX_H_
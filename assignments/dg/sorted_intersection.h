@@ -0,0 +1,61 @@
+#ifndef ASSIGNMENTS_DG_SORTED_INTERSECTION_H_
+#define ASSIGNMENTS_DG_SORTED_INTERSECTION_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+
+namespace gdwg {
+
+namespace intersection_detail {
+
+// lists this many times longer than the other are searched instead of merged
+constexpr std::size_t gallop_ratio = 32;
+
+}  // namespace intersection_detail
+
+// number of values in both of two sorted ranges of distinct values
+// the merge has no data dependent branches, so it runs at the same speed whatever the overlap,
+// and compilers can keep it in registers, a much shorter range is galloped through the longer
+template <typename It>
+std::size_t IntersectionSize(It first1, It last1, It first2, It last2) {
+  auto size1 = static_cast<std::size_t>(std::distance(first1, last1));
+  auto size2 = static_cast<std::size_t>(std::distance(first2, last2));
+  if (size1 > size2) {
+    return IntersectionSize(first2, last2, first1, last1);
+  }
+  std::size_t count = 0;
+  if (size1 * intersection_detail::gallop_ratio < size2) {
+    for (; first1 != last1 && first2 != last2; ++first1) {
+      first2 = std::lower_bound(first2, last2, *first1);
+      count += first2 != last2 && *first2 == *first1;
+    }
+    return count;
+  }
+  while (first1 != last1 && first2 != last2) {
+    auto value1 = *first1;
+    auto value2 = *first2;
+    count += value1 == value2;
+    first1 += value1 <= value2;
+    first2 += value2 <= value1;
+  }
+  return count;
+}
+
+// call fn(value) on every value in both of two sorted ranges of distinct values
+template <typename It, typename F>
+void ForEachCommon(It first1, It last1, It first2, It last2, F&& fn) {
+  while (first1 != last1 && first2 != last2) {
+    auto value1 = *first1;
+    auto value2 = *first2;
+    if (value1 == value2) {
+      fn(value1);
+    }
+    first1 += value1 <= value2;
+    first2 += value2 <= value1;
+  }
+}
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_SORTED_INTERSECTION_H_
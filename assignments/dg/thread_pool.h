@@ -0,0 +1,157 @@
+#ifndef ASSIGNMENTS_DG_THREAD_POOL_H_
+#define ASSIGNMENTS_DG_THREAD_POOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gdwg {
+
+// fixed set of worker threads for the parallel graph algorithms
+// ParallelFor() hands out chunks of an index range from a shared counter, so threads that finish
+// early take more chunks, and the calling thread works as thread 0
+// one ParallelFor() runs at a time, a ParallelFor() called from inside one runs serially
+class ThreadPool {
+ public:
+  // threads counts the calling thread, so threads - 1 workers are started
+  explicit ThreadPool(std::size_t threads) {
+    for (std::size_t thread = 1; thread < threads; ++thread) {
+      workers_.emplace_back([this, thread] { Work(thread); });
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  // pool with a thread per hardware thread, shared by every graph
+  static ThreadPool& Shared() {
+    static ThreadPool pool{std::max(1u, std::thread::hardware_concurrency())};
+    return pool;
+  }
+
+  std::size_t ThreadCount() const noexcept { return workers_.size() + 1; }
+
+  // call fn(begin, end, thread) on chunks of [0, count) of at most grain indices, on up to
+  // threads threads, all of them if 0, and return once every chunk is done
+  // thread is below ThreadCount(), for per-thread buffers, the first exception thrown by fn is
+  // rethrown here
+  template <typename F>
+  void ParallelFor(std::size_t count, std::size_t grain, F&& fn, std::size_t threads = 0) {
+    if (threads == 0 || threads > ThreadCount()) {
+      threads = ThreadCount();
+    }
+    grain = std::max<std::size_t>(grain, 1);
+    threads = std::min(threads, (count + grain - 1) / grain);
+    if (threads <= 1 || InWorker()) {
+      for (std::size_t begin = 0; begin < count; begin += grain) {
+        fn(begin, std::min(begin + grain, count), std::size_t{0});
+      }
+      return;
+    }
+
+    std::lock_guard<std::mutex> running{run_mutex_};
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    std::function<void(std::size_t)> job = [&](std::size_t thread) {
+      try {
+        for (std::size_t begin = next.fetch_add(grain); begin < count;
+             begin = next.fetch_add(grain)) {
+          fn(begin, std::min(begin + grain, count), thread);
+        }
+      } catch (...) {
+        // skip the remaining chunks
+        next = count;
+        std::lock_guard<std::mutex> lock{error_mutex};
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    };
+
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      job_ = &job;
+      threads_ = threads;
+      pending_ = threads - 1;
+      ++generation_;
+    }
+    wake_.notify_all();
+    InWorker() = true;
+    job(0);
+    InWorker() = false;
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      done_.wait(lock, [this] { return pending_ == 0; });
+      job_ = nullptr;
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+ private:
+  // helper function, if this thread is running a chunk
+  static bool& InWorker() {
+    thread_local bool in_worker = false;
+    return in_worker;
+  }
+
+  // helper function, loop of worker thread, waiting for jobs it takes part in
+  void Work(std::size_t thread) {
+    InWorker() = true;
+    std::size_t seen = 0;
+    std::unique_lock<std::mutex> lock{mutex_};
+    while (true) {
+      wake_.wait(lock, [this, seen] { return stop_ || generation_ != seen; });
+      if (stop_) {
+        return;
+      }
+      seen = generation_;
+      if (thread >= threads_) {
+        continue;
+      }
+      auto* job = job_;
+      lock.unlock();
+      (*job)(thread);
+      lock.lock();
+      if (--pending_ == 0) {
+        done_.notify_one();
+      }
+    }
+  }
+
+  // the current job, run by threads 0 to threads_ - 1, pending_ counts workers still running it
+  std::vector<std::thread> workers_;
+  std::mutex run_mutex_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  const std::function<void(std::size_t)>* job_ = nullptr;
+  std::size_t threads_ = 0;
+  std::size_t pending_ = 0;
+  std::size_t generation_ = 0;
+  bool stop_ = false;
+};
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_THREAD_POOL_H_